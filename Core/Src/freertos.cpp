@@ -28,11 +28,13 @@
 /* USER CODE BEGIN Includes */
 #include "usart.h"
 #include "printf.h"
+#include "message_buffer.h"
 #include <hm10.hpp>
 #include <cstring>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
+typedef StaticTask_t osStaticThreadDef_t;
 /* USER CODE BEGIN PTD */
 
 /* USER CODE END PTD */
@@ -50,14 +52,19 @@
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
 HM10::HM10 hm10(&HM10_UART);
-char hm_message_buffer[128] { };
-bool message_received = false;
+// Received frames, one message per frame - the main task blocks on it instead of polling a flag
+uint8_t hm_messages_storage[256];
+StaticMessageBuffer_t hm_messages_control_block;
+MessageBufferHandle_t hm_messages;
 
 /* USER CODE END Variables */
 /* Definitions for mainTask */
 osThreadId_t mainTaskHandle;
-osThreadAttr_t const mainTask_attributes = { .name = "mainTask", .stack_size = 512 * 4, .priority =
-    (osPriority_t) osPriorityNormal, };
+uint32_t mainTaskBuffer[512];
+osStaticThreadDef_t mainTaskControlBlock;
+osThreadAttr_t const mainTask_attributes = { .name = "mainTask", .cb_mem = &mainTaskControlBlock, .cb_size =
+    sizeof(mainTaskControlBlock), .stack_mem = &mainTaskBuffer[0], .stack_size = sizeof(mainTaskBuffer),
+                                             .priority = (osPriority_t) osPriorityNormal, };
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN FunctionPrototypes */
@@ -73,7 +80,6 @@ void testConnectionUpdating();
 void testCharacteristicValue();
 void testNotifications();
 
-void dataCallback(char* data, std::size_t length);
 void connectedCallback(HM10::MACAddress const& mac);
 void disconnectedCallback();
 /* USER CODE END FunctionPrototypes */
@@ -148,6 +154,9 @@ void StartMainTask(void* argument) {
     osDelay(100);
   }
 
+  // Probed only now - with no module attached, it'd add ~400ms of timeouts to initialize()
+  printf("Firmware: %s\n", HM10::firmwareCapabilities(hm10.detectFirmware()).name);
+
   printf("===== TESTS STARTING =====\n");
 
   testFactoryReset();
@@ -165,9 +174,13 @@ void StartMainTask(void* argument) {
   HM10::Version version = hm10.firmwareVersion();
   printf("Firmware version: %s\n", version.version);
 
-  hm10.setDataCallback(dataCallback);
-  hm10.setDeviceConnectedCallback(connectedCallback);
-  hm10.setDeviceDisconnectedCallback(disconnectedCallback);
+  hm_messages = xMessageBufferCreateStatic(sizeof(hm_messages_storage), hm_messages_storage,
+                                           &hm_messages_control_block);
+  hm10.setDataMessageBuffer(hm_messages);
+  // printf can't be called from the UART interrupt - these callbacks run in the timer service task
+  // (ITM printf doesn't block, which is all the timer task allows)
+  hm10.setDeviceConnectedCallback(connectedCallback, HM10::CallbackDispatch::Deferred);
+  hm10.setDeviceDisconnectedCallback(disconnectedCallback, HM10::CallbackDispatch::Deferred);
 
   hm10.setAutomaticMode(true);
   printf("Automatic mode: %s\n", hm10.automaticMode() ? "enabled" : "disabled");
@@ -210,14 +223,13 @@ void StartMainTask(void* argument) {
   printf("===== TESTS DONE! =====\n");
 
   char const* response = "test response";
+  char message[HM10_BUFFER_SIZE + 1] { };
 
   for (;;) {
-    osDelay(1);
-    if (message_received) {
-      printf("%d BYTES FROM MASTER: %s\n", std::strlen(hm_message_buffer), hm_message_buffer);
-      hm10.sendData((uint8_t const*) response, std::strlen(response));
-      message_received = false;
-    }
+    std::size_t const length = xMessageBufferReceive(hm_messages, message, HM10_BUFFER_SIZE, portMAX_DELAY);
+    message[length] = '\0';
+    printf("%d BYTES FROM MASTER: %s\n", static_cast<int>(length), message);
+    hm10.sendData((uint8_t const*) response, std::strlen(response));
   }
   /* USER CODE END StartMainTask */
 }
@@ -240,7 +252,9 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
 
 void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
   if (huart == &HM10_UART) {
-    printf("UART error - code %d (0x%02X)\n", huart->ErrorCode, huart->ErrorCode);
+    // Restarts the reception if the error stopped it - no printing here, it'd only make the outage longer.
+    // Errors are counted in hm10.linkStatistics().
+    hm10.errorOccurred();
   }
 }
 
@@ -248,7 +262,7 @@ extern "C" void HM10_UART_HandleIdleLine() {
   if (__HAL_UART_GET_FLAG(&HM10_UART, UART_FLAG_IDLE)) {
     __HAL_UART_CLEAR_IDLEFLAG(&HM10_UART);
     HAL_GPIO_WritePin(BOARD_LED_GPIO_Port, BOARD_LED_Pin, GPIO_PIN_SET);
-    hm10.receiveCompleted();
+    hm10.idleLineDetected();
   }
 }
 
@@ -350,11 +364,6 @@ void testNotifications() {
          (hm10.notificationsWithAddress() ? "with" : "without"));
 }
 
-void dataCallback(char* data, std::size_t length) {
-  std::memcpy(hm_message_buffer, data, length);
-  message_received = true;
-}
-
 void connectedCallback(HM10::MACAddress const& mac) {
   printf("Connected to master with MAC address %s\n", mac.address);
 }
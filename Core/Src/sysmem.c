@@ -23,8 +23,22 @@
 
 /* Includes */
 #include <errno.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#ifdef HM10_STATIC_ALLOCATION
+/*
+ * Heap-free build - nothing should ever call malloc. If anything does, the reference below
+ * fails the link. Relies on unused sections being discarded (-ffunction-sections, --gc-sections),
+ * so the trap is only linked in when _sbrk is actually reachable.
+ */
+extern void *__heap_used_in_HM10_STATIC_ALLOCATION_build(ptrdiff_t incr);
+
+void *_sbrk(ptrdiff_t incr)
+{
+  return __heap_used_in_HM10_STATIC_ALLOCATION_build(incr);
+}
+#else
 /**
  * Pointer to the current high watermark of the heap usage
  */
@@ -78,3 +92,4 @@ void *_sbrk(ptrdiff_t incr)
 
   return (void *)prev_heap_end;
 }
+#endif /* HM10_STATIC_ALLOCATION */
@@ -6,14 +6,43 @@
  */
 
 #include "hm10.hpp"
+#include "hm10_beacon.hpp"
 #include "hm10_debug.hpp"
+#include "hm10_events.hpp"
+#include "hm10_format.hpp"
+#include "hm10_platform.hpp"
+#include "hm10_transport.hpp"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
 
 namespace HM10 {
 
+namespace {
+
+// Module wakes up after receiving a string longer than 80 characters
+constexpr std::size_t WakeUpBurstLength { 96 };
+constexpr char WakeUpBurstCharacter { 'I' };
+
+// Every firmware answers the version query right away, the probe doesn't have to wait as long as other commands
+constexpr std::uint32_t FirmwareProbeTimeout { 200 };
+
+// One more byte for the terminator, the burst is logged as a string
+static_assert(WakeUpBurstLength < HM10_BUFFER_SIZE, "HM10_BUFFER_SIZE is too small to hold wake up burst");
+
+// newlib's vsnprintf may allocate, heap-free builds use the driver's own formatter
+int formatToBuffer(char* buffer, std::size_t size, char const* format, std::va_list args) {
+#ifdef HM10_STATIC_ALLOCATION
+  return formatString(buffer, size, format, args);
+#else
+  return vsnprintf(buffer, size, format, args);
+#endif
+}
+
+}
+
 // ===== Constructor, getters/setters, public utils ===== //
 
 HM10::HM10(UART_HandleTypeDef* uart) {
@@ -34,36 +63,146 @@ std::size_t HM10::bufferSize() const {
   return HM10_BUFFER_SIZE;
 }
 
-void HM10::setDataCallback(DataCallbackT callback) {
+void HM10::setDataCallback(DataCallbackT callback, CallbackDispatch dispatch) {
   m_dataCallback = callback;
+  m_dataDispatch = dispatch;
 }
 
-void HM10::setDeviceConnectedCallback(DeviceConnectedT callback) {
+void HM10::setDeviceConnectedCallback(DeviceConnectedT callback, CallbackDispatch dispatch) {
   m_deviceConnectedCallback = callback;
+  m_deviceConnectedDispatch = dispatch;
 }
 
-void HM10::setDeviceDisconnectedCallback(DeviceDisconnectedT callback) {
+void HM10::setDeviceDisconnectedCallback(DeviceDisconnectedT callback, CallbackDispatch dispatch) {
   m_deviceDisconnectedCallback = callback;
+  m_deviceDisconnectedDispatch = dispatch;
 }
 
-int HM10::initialize() {
+#ifdef USE_RTOS_DELAY
+void HM10::setEventBus(EventBus* eventBus) {
+  m_eventBus = eventBus;
+}
+
+void HM10::setDataStreamBuffer(StreamBufferHandle_t buffer) {
+  m_dataStreamBuffer = buffer;
+}
+
+void HM10::setDataMessageBuffer(MessageBufferHandle_t buffer) {
+  m_dataMessageBuffer = buffer;
+}
+#endif
+
+int HM10::initialize(bool detectFirmware) {
+#if defined(HM10_PROFILING) || defined(HM10_TRACE_ENABLED)
+  enableCycleCounter();
+#endif
   debugLog("Init started");
-  __HAL_UART_ENABLE_IT(UART(), UART_IT_IDLE);
-  return HAL_UART_Receive_DMA(UART(), reinterpret_cast<uint8_t*>(&m_rxBuffer[0]), bufferSize());
+  int const result = Transport::startReception(UART(), reinterpret_cast<std::uint8_t*>(&m_rxBuffer[0]), bufferSize());
+  applyFrameBoundary();
+  if (result == HAL_OK && detectFirmware) {
+    this->detectFirmware();
+  }
+  return result;
+}
+
+void HM10::idleLineDetected() {
+  switch (m_frameBoundary) {
+  case FrameBoundary::IdleLine:
+    receiveCompleted();
+    break;
+  case FrameBoundary::Terminator:
+    // Fragment without the terminator waits for the rest, or for the timeout in timerTick
+    if (frameTerminated()) {
+      receiveCompleted();
+    }
+    break;
+  case FrameBoundary::Timeout:
+    // Interrupt is disabled, timerTick ends the messages
+    break;
+  }
+}
+
+void HM10::timerTick() {
+  if (m_frameBoundary == FrameBoundary::IdleLine) {
+    return;
+  }
+
+  char const* const writePtr = dmaWritePointer();
+  if (writePtr == m_msgStartPtr || writePtr != m_lastWritePtr) {
+    // Nothing received, or still receiving
+    m_lastWritePtr = writePtr;
+    m_silentTicks = 0;
+    return;
+  }
+
+  m_silentTicks++;
+  if (m_silentTicks >= m_frameTimeoutTicks) {
+    m_silentTicks = 0;
+    receiveCompleted();
+  }
+}
+
+void HM10::setFrameBoundary(FrameBoundary boundary, std::uint32_t timeoutTicks) {
+  {
+    CriticalSection const criticalSection { };
+    m_frameBoundary = boundary;
+    m_frameTimeoutTicks = (timeoutTicks > 0 ? timeoutTicks : 1);
+    m_silentTicks = 0;
+  }
+  applyFrameBoundary();
+}
+
+FrameBoundary HM10::frameBoundary() const {
+  return m_frameBoundary;
+}
+
+void HM10::setFrameTerminator(char const* terminator) {
+  CriticalSection const criticalSection { };
+  m_terminatorLength = 0;
+  while (terminator[m_terminatorLength] != '\0' && m_terminatorLength < sizeof(m_terminator) - 1) {
+    m_terminator[m_terminatorLength] = terminator[m_terminatorLength];
+    m_terminatorLength++;
+  }
+}
+
+bool HM10::frameTerminated() {
+  char const* const writePtr = dmaWritePointer();
+  bool const wrapped = (writePtr < m_msgStartPtr);
+  std::size_t const pending = wrapped ? (m_rxBufferEnd - m_msgStartPtr) + (writePtr - &m_rxBuffer[0])
+                                      : writePtr - m_msgStartPtr;
+  if (pending == 0 || pending < m_terminatorLength) {
+    return false;
+  }
+
+  // Compared backwards from the last received byte, the terminator can be split by the buffer end
+  char const* position = writePtr;
+  for (std::size_t i = m_terminatorLength; i > 0; i--) {
+    position = (position == &m_rxBuffer[0] ? m_rxBufferEnd : position) - 1;
+    if (*position != m_terminator[i - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HM10::applyFrameBoundary() {
+  Transport::setIdleLineInterrupt(UART(), m_frameBoundary != FrameBoundary::Timeout);
 }
 
 void HM10::receiveCompleted() {
-  char* const messageEndPtr = &m_rxBuffer[0]
-                              + (bufferSize() - __HAL_DMA_GET_COUNTER(UART()->hdmarx));
+  HM10_PROFILE(m_profilingStats, ProfilingSite::ReceiveCompleted);
+  char* const messageEndPtr = dmaWritePointer();
   // debugLog("Bytes left in buffer: %d\n", __HAL_DMA_GET_COUNTER(UART()->hdmarx));
 
+  // Spurious idle line interrupt, there's nothing new in the buffer
+  if (messageEndPtr == m_msgStartPtr) {
+    return;
+  }
+
   // We need to check if DMA has rolled over the buffer during the rx procedure.
-  // DMA counter rolls back to 128 when buffer ends, so there will never be a situation
-  // where messageEndPtr is invalid (pointing to memory outside of the buffer).
-  // At the same time, there should never be 0 characters in buffer so
-  // checking for equality is pointless, yet i'm still gonna do that just-in-case so it's
-  // not handled like split message.
-  if (m_msgStartPtr <= messageEndPtr) {
+  // Both parts together are always shorter than the buffer, so the message and terminator fit in m_messageBuffer.
+  bool const wrapped = (m_msgStartPtr > messageEndPtr);
+  if (!wrapped) {
     // DMA hasn't rolled over, message is in one, linear piece
     std::size_t const messageLength = messageEndPtr - m_msgStartPtr;
     std::memcpy(&m_messageBuffer[0], m_msgStartPtr, messageLength);
@@ -88,27 +227,119 @@ void HM10::receiveCompleted() {
 #endif
 
   m_msgStartPtr = messageEndPtr;
+  m_statistics.received(m_messageLength, wrapped);
+#ifdef HM10_CAPTURE
+  if (m_capture != nullptr) {
+    m_capture->record(isReceiving() ? CaptureRecordType::Response : CaptureRecordType::Receive,
+                      m_messageBuffer, m_messageLength);
+  }
+#endif
+
+  if (m_beaconTable != nullptr) {
+    m_beaconTable->ingest(m_messageBuffer, m_messageLength, platformTicks());
+    m_rxInProgress = false;
+    return;
+  }
 
   // Unexpected data - either information about new connection/disconnection
   // or data for the application
-  if (!isReceiving() && !handleConnectionMessage() && m_dataCallback != nullptr) {
+  if (!isReceiving() && !handleConnectionMessage(true)) {
+    m_receivedDataBytes += m_messageLength;
+    m_lastDataActivity = platformTicks();
+
+    char* payload { m_messageBuffer };
+    std::size_t payloadLength { m_messageLength };
     if (rfCommMode()) {
       // HM-10 automagically joins parts of the >20B message, so the first byte is not necessary.
       // We'll still keep it as messageLength in case something goes wrong, because i haven't tested
       // if it joins up the message in *every* case.
-      m_dataCallback(m_messageBuffer + 1, m_messageBuffer[0]);
-    } else {
-      m_dataCallback(m_messageBuffer, m_messageLength);
+      // Length byte can't be trusted - it's clamped to what was actually received.
+      std::size_t const length = static_cast<std::uint8_t>(m_messageBuffer[0]);
+      payload = m_messageBuffer + 1;
+      payloadLength = (length < m_messageLength ? length : m_messageLength - 1);
+    }
+
+    if (m_dataCallback != nullptr
+        && !deferCallback(m_dataDispatch, DeferredEvent::Type::Data, payload, payloadLength, true)) {
+      m_dataCallback(payload, payloadLength);
     }
+#ifdef USE_RTOS_DELAY
+    if (m_eventBus != nullptr) {
+      m_eventBus->publishData(payload, payloadLength);
+    }
+    forwardData(payload, payloadLength);
+#endif
   }
 
+  bool const responseReceived = isReceiving();
   m_rxInProgress = false;
+  if (responseReceived && m_completionCallback != nullptr) {
+    m_completionCallback(m_completionContext);
+  }
 }
 
 void HM10::transmitCompleted() {
+  HM10_PROFILE(m_profilingStats, ProfilingSite::TransmitCompleted);
   m_txInProgress = false;
+  if (m_completionCallback != nullptr) {
+    m_completionCallback(m_completionContext);
+  }
+}
+
+void HM10::errorOccurred() {
+  std::uint32_t const errorCode = Transport::errorCode(UART());
+  debugLog("UART error, code 0x%02X", static_cast<unsigned>(errorCode));
+  m_statistics.uartError(errorCode);
+#ifdef HM10_CAPTURE
+  if (m_capture != nullptr) {
+    m_capture->record(CaptureRecordType::UARTError, &errorCode, sizeof(errorCode));
+  }
+#endif
+
+  // Receive errors can stop RX DMA (HAL aborts it on every one of them), TX DMA errors leave the reception
+  // running, so there's nothing to do then.
+  if (Transport::receptionStopped(UART())) {
+    restartReception();
+  }
+}
+
+void HM10::restartReception() {
+  // Unfinished message can't be trusted (there's a byte missing or broken somewhere), so it's thrown away.
+  // If it was a response, the command will get the rest of it (and fail on compare) or time out.
+  char const* const stopPtr = dmaWritePointer();
+  bool const wrapped = (stopPtr < m_msgStartPtr);
+  std::size_t const discarded = wrapped ? (m_rxBufferEnd - m_msgStartPtr) + (stopPtr - &m_rxBuffer[0])
+                                        : stopPtr - m_msgStartPtr;
+
+  bool const restarted = Transport::restartReception(UART(), reinterpret_cast<std::uint8_t*>(&m_rxBuffer[0]),
+                                                    bufferSize()) == HAL_OK;
+  // DMA starts writing from the beginning of the buffer again
+  m_msgStartPtr = &m_rxBuffer[0];
+  applyFrameBoundary();
+  m_statistics.receptionRestarted(discarded, restarted);
+  debugLog("RX restarted: %s, %d bytes discarded", restarted ? "yes" : "no", static_cast<int>(discarded));
+}
+
+char* HM10::dmaWritePointer() {
+  // DMA counter rolls back to buffer size when buffer ends, but it can read 0 for a moment before
+  // the reload (and anything, if DMA is misconfigured), so it's clamped to keep the pointer inside the buffer.
+  std::size_t const bytesLeft = Transport::receiveCounter(UART());
+  std::size_t const position = (bytesLeft == 0 || bytesLeft > bufferSize()) ? 0 : bufferSize() - bytesLeft;
+  return &m_rxBuffer[0] + position;
+}
+
+#ifdef HM10_PROFILING
+ProfilingStatistics HM10::stats() const {
+  CriticalSection const criticalSection { };
+  return m_profilingStats;
 }
 
+void HM10::resetStats() {
+  CriticalSection const criticalSection { };
+  m_profilingStats = ProfilingStatistics { };
+}
+#endif
+
 bool HM10::isBusy() const {
   return (isReceiving() || isTransmitting());
 }
@@ -137,6 +368,40 @@ MACAddress HM10::masterMAC() const {
   return m_connectedMAC;
 }
 
+std::uint32_t HM10::receivedDataBytes() const {
+  return m_receivedDataBytes;
+}
+
+std::uint32_t HM10::lastDataActivity() const {
+  return m_lastDataActivity;
+}
+
+std::uint32_t HM10::linkLostTime() const {
+  return m_linkLostTime;
+}
+
+CommandStatistics HM10::commandStatistics(char const* command) const {
+  return m_statistics.command(commandIndex(command));
+}
+
+CommandStatistics HM10::commandStatistics(std::size_t index) const {
+  return m_statistics.command(index);
+}
+
+LinkStatistics HM10::linkStatistics() const {
+  return m_statistics.link();
+}
+
+void HM10::resetStatistics() {
+  m_statistics.reset();
+}
+
+#ifdef HM10_CAPTURE
+void HM10::setCapture(Capture* capture) {
+  m_capture = capture;
+}
+#endif
+
 // ===== Functionality ===== //
 
 bool HM10::isAlive() {
@@ -184,6 +449,7 @@ bool HM10::reboot(bool waitForStartup) {
 bool HM10::factoryReset(bool waitForStartup) {
   if (transmitAndCheckResponse("OK+RENEW", "AT+RENEW")) {
     m_factoryRebootPending = true;
+    m_autoSleep = false;
     return reboot(waitForStartup);
   } else {
     return false;
@@ -546,14 +812,19 @@ bool HM10::setModulePower(ModulePower new_power) {
 bool HM10::autoSleep() {
   debugLog("Checking auto sleep state");
   if (transmitAndCheckResponse("OK+Get", "AT+PWRM?")) {
-    return static_cast<bool>(extractNumberFromResponse());
+    m_autoSleep = (extractNumberFromResponse() == 0);
+    return m_autoSleep;
   }
   return false;
 }
 
 bool HM10::setAutoSleep(bool enabled) {
   debugLog("Setting auto sleep state to %s", (enabled ? "enabled" : "disabled"));
-  return transmitAndCheckResponse("OK+Set", "AT+PWRM%d", (enabled ? 0 : 1));
+  if (transmitAndCheckResponse("OK+Set", "AT+PWRM%d", (enabled ? 0 : 1))) {
+    m_autoSleep = enabled;
+    return true;
+  }
+  return false;
 }
 
 bool HM10::reliableAdvertising() {
@@ -589,12 +860,68 @@ bool HM10::start() {
 
 bool HM10::sleep() {
   debugLog("Putting the module into sleep mode");
-  return transmitAndCheckResponse("OK+SLEEP", "AT+SLEEP");
+  if (transmitAndCheckResponse("OK+SLEEP", "AT+SLEEP")) {
+    m_powerState = PowerState::Asleep;
+    return true;
+  }
+  return false;
 }
 
-bool HM10::wakeUp() {
+bool HM10::wakeUp(std::uint32_t timeout) {
+  PowerState const state = powerState();
+  if (state == PowerState::Awake) {
+    return true;
+  }
+
+  // Module sleeps only when it's not connected - and while it is, both the burst and the "AT" probe below
+  // would go to the peer (and "AT" drops the link)
+  if (isConnected()) {
+    m_powerState = PowerState::Awake;
+    return true;
+  }
+
+  if (state == PowerState::Asleep && m_uartShutdownKnown && m_uartShutdownOnSleep) {
+    debugLog("UART is shut down during sleep, can't wake the module up");
+    return false;
+  }
+
+  // Awake module ignores the burst, so the unknown state is checked first - otherwise waking up an awake module
+  // would take the whole timeout. The response to AT marks it awake.
+  if (state == PowerState::Unknown && isAlive()) {
+    return true;
+  }
+
   debugLog("Waking the module up");
-  return transmitAndCheckResponse("OK+WAKE", "WAKEUP");
+  std::memset(m_txBuffer, WakeUpBurstCharacter, WakeUpBurstLength);
+  m_txBuffer[WakeUpBurstLength] = '\0';
+  m_txDataLength = WakeUpBurstLength;
+
+  std::uint32_t const startTime = platformTicks();
+  if (!transmitAndReceive(timeout)) {
+    return false;
+  }
+
+  if (!compareWithResponse("OK+WAKE")) {
+    return false;
+  }
+
+  m_wakeUpLatency = platformTicks() - startTime;
+  m_powerState = PowerState::Awake;
+  debugLog("Module woke up after %d ms", m_wakeUpLatency);
+  return true;
+}
+
+PowerState HM10::powerState() const {
+  // In auto sleep mode, the module falls asleep by itself when it's idle and not connected
+  if (m_powerState == PowerState::Awake && m_autoSleep && !m_isConnected
+      && platformTicks() - m_lastModuleActivity >= HM10_AUTO_SLEEP_IDLE_TIME) {
+    return PowerState::Unknown;
+  }
+  return m_powerState;
+}
+
+std::uint32_t HM10::wakeUpLatency() const {
+  return m_wakeUpLatency;
 }
 
 BondMode HM10::bondingMode() {
@@ -632,14 +959,21 @@ bool HM10::setServiceUUID(std::uint16_t new_uuid) {
 bool HM10::uartShutdownOnSleep() {
   debugLog("Checking if UART will shutdown on sleep");
   if (transmitAndCheckResponse("OK+Get", "AT+UART?")) {
-    return static_cast<bool>(extractNumberFromResponse());
+    m_uartShutdownOnSleep = static_cast<bool>(extractNumberFromResponse());
+    m_uartShutdownKnown = true;
+    return m_uartShutdownOnSleep;
   }
   return false;
 }
 
 bool HM10::setUARTShutdownOnSleep(bool state) {
   debugLog("Setting UART shutdown on sleep to %s", (state ? "enabled" : "disabled"));
-  return transmitAndCheckResponse("OK+Set", "AT+UART%d", (state ? 1 : 0));
+  if (transmitAndCheckResponse("OK+Set", "AT+UART%d", (state ? 1 : 0))) {
+    m_uartShutdownOnSleep = state;
+    m_uartShutdownKnown = true;
+    return true;
+  }
+  return false;
 }
 
 bool HM10::setAdvertisementData(char const* data) {
@@ -657,19 +991,143 @@ Version HM10::firmwareVersion() {
   return ver;
 }
 
-bool HM10::sendData(std::uint8_t const* data, std::size_t length, bool waitForTx) {
-  if (isConnected()) {
-    m_txInProgress = true;
-    int transmit_result = HAL_UART_Transmit_DMA(UART(), const_cast<std::uint8_t*>(data), length);
-    if (transmit_result == HAL_OK) {
-      if (waitForTx) {
-        waitForTransmitCompletion();
+Firmware HM10::detectFirmware() {
+  // Probe with every command allowed, the previous result doesn't matter
+  m_firmware = Firmware::Unknown;
+
+  // HMSoft answers "HMSoft V709", major version is the first digit
+  copyCommandToBuffer("AT+VERR?");
+  if (transmitAndReceive(FirmwareProbeTimeout) && compareWithResponse("HMSoft")) {
+    char const* const version = std::strstr(m_messageBuffer, " V");
+    m_firmware = (version != nullptr && version[2] >= '7' && version[2] <= '9') ? Firmware::HMSoftV7
+                                                                              : Firmware::HMSoftV6;
+  } else {
+    // Clones ignore AT+VERR?, they want AT+VERSION with line ending ("+VERSION=..." or just the version string)
+    copyCommandToBuffer("AT+VERSION\r\n");
+    if (transmitAndReceive(FirmwareProbeTimeout)) {
+      if (std::strstr(m_messageBuffer, "BT05") != nullptr) {
+        m_firmware = Firmware::MLTBT05;
+      } else if (std::strstr(m_messageBuffer, "CC41") != nullptr
+          || std::strstr(m_messageBuffer, "Bolutek") != nullptr) {
+        m_firmware = Firmware::CC41A;
       }
-      return true;
-    } else {
-      transmitCompleted();
     }
   }
+
+  debugLog("Detected firmware: %s", capabilities().name);
+  return m_firmware;
+}
+
+Firmware HM10::firmware() const {
+  return m_firmware;
+}
+
+FirmwareCapabilities const& HM10::capabilities() const {
+  return firmwareCapabilities(m_firmware);
+}
+
+bool HM10::supports(char const* command) const {
+  return capabilities().supports(commandIndex(command));
+}
+
+int HM10::rssi() {
+  debugLogLL("Getting RSSI");
+  // Peer's data arriving in the meantime doesn't count as the reply
+  if (transmitAndCheckResponse("OK+RSSI:", "AT+RSSI?")) {
+    return static_cast<int>(std::strtol(&m_messageBuffer[8], nullptr, 10));
+  }
+  return 0;
+}
+
+bool HM10::connect(char const* address, std::uint32_t timeout) {
+  debugLog("Connecting to %s", address);
+  m_connectionFailed = false;
+
+  // OK+CONNA means that the module accepted the address and started connecting,
+  // result (OK+CONN or OK+CONNF) will come later as unexpected message.
+  if (!transmitAndCheckResponse("OK+CONNA", "AT+CON%s", address)) {
+    return false;
+  }
+
+  if (!waitForConnection(timeout)) {
+    return false;
+  }
+
+  if (m_connectedMAC.address[0] == '\0') {
+    std::strncpy(m_connectedMAC.address, address, sizeof(m_connectedMAC.address) - 1);
+  }
+  return true;
+}
+
+bool HM10::connectLast(std::uint32_t timeout) {
+  debugLog("Connecting to the last device");
+  m_connectionFailed = false;
+
+  // OK+CONNL - connecting, OK+CONNN - there's no last address, OK+CONNE - error
+  if (!transmitAndCheckResponse("OK+CONNL", "AT+CONNL")) {
+    return false;
+  }
+  return waitForConnection(timeout);
+}
+
+bool HM10::waitForConnection(std::uint32_t timeout) {
+  std::uint32_t const startTime = platformTicks();
+  while (!isConnected() && !m_connectionFailed) {
+    if (platformTicks() - startTime >= timeout) {
+      debugLog("Connection timeout");
+      return false;
+    }
+    platformDelay(1);
+  }
+  return isConnected();
+}
+
+bool HM10::disconnect() {
+  if (!isConnected()) {
+    return true;
+  }
+
+  debugLog("Disconnecting from %s", m_connectedMAC.address);
+  // Bare "AT" while connected makes the module drop the connection (anything else goes to the peer)
+  copyCommandToBuffer("AT");
+  if (!transmitAndReceive()) {
+    return false;
+  }
+
+  // OK+LOST came as a response, so it wasn't handled by receiveCompleted - handled here, in the calling task
+  handleConnectionMessage(false);
+  return !isConnected();
+}
+
+bool HM10::discoverBeacons(BeaconTable& table, std::uint32_t timeout) {
+  debugLog("Starting iBeacon scan");
+  table.beginScan();
+  m_beaconTable = &table;
+
+  copyCommandToBuffer("AT+DISI?");
+  // First response is OK+DISIS, the records and OK+DISCE will come later
+  if (!transmitAndReceive()) {
+    m_beaconTable = nullptr;
+    return false;
+  }
+
+  std::uint32_t const startTime = platformTicks();
+  while (!table.scanFinished() && platformTicks() - startTime < timeout) {
+    platformDelay(1);
+  }
+
+  m_beaconTable = nullptr;
+  debugLog("Scan finished, %d beacons in table", table.size());
+  return table.scanFinished();
+}
+
+bool HM10::sendData(std::uint8_t const* data, std::size_t length, bool waitForTx) {
+  if (isConnected() && startDataTransmission(data, length) == HAL_OK) {
+    if (waitForTx) {
+      waitForTransmitCompletion();
+    }
+    return true;
+  }
   return false;
 }
 
@@ -677,50 +1135,235 @@ bool HM10::printf(char const* fmt, ...) {
   std::va_list args;
   va_start(args, fmt);
   if (rfCommMode()) {
-    m_txDataLength = vsnprintf(&m_txBuffer[1], bufferSize() - 1, fmt, args) + 1;
+    int const length = formatToBuffer(&m_txBuffer[1], bufferSize() - 1, fmt, args);
+    m_txDataLength = (length < 0 ? 0 : std::min<std::size_t>(length, bufferSize() - 2)) + 1;
     m_txBuffer[0] = static_cast<std::uint8_t>(m_txDataLength - 1);
   } else {
     copyCommandToBufferVarg(fmt, args);
   }
   va_end(args);
 
+  m_lastDataActivity = platformTicks();
   return transmitBuffer() == HAL_OK;
 }
 
 // ===== Private/low-level/utility functions ===== //
 
-bool HM10::handleConnectionMessage() {
-  if (compareWithResponse("OK+CONN")) {
+bool HM10::handleConnectionMessage(bool fromInterrupt) {
+  // Any message from the module means it's awake, unless it says otherwise
+  if (compareWithResponse("OK+SLEEP")) {
+    m_powerState = PowerState::Asleep;
+    return true;
+  }
+  m_powerState = PowerState::Awake;
+  m_lastModuleActivity = platformTicks();
+  if (compareWithResponse("OK+WAKE")) {
+    return true;
+  }
+
+  // Central role connection progress messages. They have to be checked before OK+CONN,
+  // because they start with the same characters.
+  if (compareWithResponse("OK+CONNA") || compareWithResponse("OK+CONNL")) {
+    return true;
+  } else if (compareWithResponse("OK+CONNE") || compareWithResponse("OK+CONNF") || compareWithResponse("OK+CONNN")) {
+    m_connectionFailed = true;
+    return true;
+  } else if (compareWithResponse("OK+CONN")) {
     m_isConnected = true;
     copyStringFromResponse(8, m_connectedMAC.address);
 //    std::memcpy(m_connectedMAC.address, m_messageBuffer, 12);
 
-    if (m_deviceConnectedCallback != nullptr) {
+    if (m_deviceConnectedCallback != nullptr
+        && !deferCallback(m_deviceConnectedDispatch, DeferredEvent::Type::Connected, m_connectedMAC.address,
+                          sizeof(m_connectedMAC.address), fromInterrupt)) {
       m_deviceConnectedCallback(m_connectedMAC);
     }
+#ifdef USE_RTOS_DELAY
+    if (m_eventBus != nullptr) {
+      m_eventBus->publishConnected(m_connectedMAC);
+    }
+#endif
 
     return true;
   } else if (compareWithResponse("OK+LOST")) {
     m_isConnected = false;
+    m_linkLostTime = platformTicks();
     std::memset(m_connectedMAC.address, '\0', sizeof(m_connectedMAC.address));
 
-    if (m_deviceDisconnectedCallback != nullptr) {
+    if (m_deviceDisconnectedCallback != nullptr
+        && !deferCallback(m_deviceDisconnectedDispatch, DeferredEvent::Type::Disconnected, nullptr, 0,
+                          fromInterrupt)) {
       m_deviceDisconnectedCallback();
     }
+#ifdef USE_RTOS_DELAY
+    if (m_eventBus != nullptr) {
+      m_eventBus->publishDisconnected();
+    }
+#endif
 
     return true;
   }
   return false;
 }
 
+#ifdef USE_RTOS_DELAY
+void HM10::forwardData(char const* data, std::size_t length) {
+  BaseType_t taskWoken { pdFALSE };
+
+  if (m_dataStreamBuffer != nullptr) {
+    std::size_t const sent = xStreamBufferSendFromISR(m_dataStreamBuffer, data, length, &taskWoken);
+    if (sent < length) {
+      m_statistics.dataDropped(length - sent);
+    }
+  }
+
+  // Message is written as a whole, or not at all
+  if (m_dataMessageBuffer != nullptr && xMessageBufferSendFromISR(m_dataMessageBuffer, data, length, &taskWoken) == 0) {
+    m_statistics.dataDropped(length);
+  }
+
+  // Switch to the woken receiver right after the interrupt, instead of waiting for the next tick
+  portYIELD_FROM_ISR(taskWoken);
+}
+#endif
+
+bool HM10::deferCallback(CallbackDispatch dispatch, DeferredEvent::Type type, char const* data, std::size_t length,
+                         bool fromInterrupt) {
+#ifdef USE_RTOS_DELAY
+  if (dispatch != CallbackDispatch::Deferred) {
+    return false;
+  }
+
+  // The slot is reserved and filled with the interrupts masked, but the FreeRTOS call is made after unmasking them
+  bool pendDispatch { false };
+  {
+    CriticalSection const criticalSection { };
+    if (m_deferredCount == HM10_DEFERRED_EVENT_COUNT) {
+      m_statistics.eventDropped();
+      return true;
+    }
+
+    DeferredEvent& event = m_deferredEvents[m_deferredHead];
+    event.type = type;
+    // Terminated like the driver's message buffer, for the callbacks that treat the data as a string
+    event.length = std::min(length, sizeof(event.data) - 1);
+    if (event.length > 0) {
+      std::memcpy(event.data, data, event.length);
+    }
+    event.data[event.length] = '\0';
+    m_deferredHead = (m_deferredHead + 1) % HM10_DEFERRED_EVENT_COUNT;
+    m_deferredCount++;
+
+    // Pended dispatch takes all the queued events, so a new one is needed only if there's none scheduled
+    pendDispatch = !m_dispatchScheduled;
+    m_dispatchScheduled = true;
+  }
+
+  if (!pendDispatch) {
+    return true;
+  }
+
+  // The FromISR variant is only for the interrupt - the task variant doesn't wait for the space in the timer queue
+  BaseType_t taskWoken { pdFALSE };
+  BaseType_t const pended = (fromInterrupt
+                             ? xTimerPendFunctionCallFromISR(&HM10::dispatchDeferredEvents, this, 0, &taskWoken)
+                             : xTimerPendFunctionCall(&HM10::dispatchDeferredEvents, this, 0, 0));
+  if (pended != pdPASS) {
+    // No dispatch was scheduled, so nothing is running it - every queued event was waiting for this one
+    CriticalSection const criticalSection { };
+    for (std::size_t i = 0; i < m_deferredCount; i++) {
+      m_statistics.eventDropped();
+    }
+    m_deferredCount = 0;
+    m_dispatchScheduled = false;
+    return true;
+  }
+
+  // With the timer service task above the application tasks (configTIMER_TASK_PRIORITY), the callback runs
+  // right after the interrupt. In a task, xTimerPendFunctionCall switches to it by itself.
+  if (fromInterrupt) {
+    portYIELD_FROM_ISR(taskWoken);
+  }
+  return true;
+#else
+  static_cast<void>(dispatch);
+  static_cast<void>(type);
+  static_cast<void>(data);
+  static_cast<void>(length);
+  static_cast<void>(fromInterrupt);
+  return false;
+#endif
+}
+
+#ifdef USE_RTOS_DELAY
+void HM10::dispatchDeferredEvents(void* module, std::uint32_t) {
+  HM10& self = *static_cast<HM10*>(module);
+  while (true) {
+    DeferredEvent* event { nullptr };
+    {
+      CriticalSection const criticalSection { };
+      if (self.m_deferredCount == 0) {
+        self.m_dispatchScheduled = false;
+        return;
+      }
+      std::size_t const tail = (self.m_deferredHead + HM10_DEFERRED_EVENT_COUNT - self.m_deferredCount)
+                               % HM10_DEFERRED_EVENT_COUNT;
+      event = &self.m_deferredEvents[tail];
+    }
+
+    // The event stays in the queue until its callback returns, so the interrupt doesn't overwrite it
+    switch (event->type) {
+    case DeferredEvent::Type::Data:
+      if (self.m_dataCallback != nullptr) {
+        self.m_dataCallback(event->data, event->length);
+      }
+      break;
+    case DeferredEvent::Type::Connected:
+      if (self.m_deviceConnectedCallback != nullptr) {
+        MACAddress mac { };
+        std::memcpy(mac.address, event->data, sizeof(mac.address));
+        self.m_deviceConnectedCallback(mac);
+      }
+      break;
+    case DeferredEvent::Type::Disconnected:
+      if (self.m_deviceDisconnectedCallback != nullptr) {
+        self.m_deviceDisconnectedCallback();
+      }
+      break;
+    }
+
+    CriticalSection const criticalSection { };
+    self.m_deferredCount--;
+  }
+}
+#endif
+
 int HM10::transmitBuffer() {
-  m_txInProgress = true;
   debugLogLL("Transmitting %s", m_txBuffer);
-  int transmit_result = HAL_UART_Transmit_DMA(UART(),
-                                              reinterpret_cast<uint8_t*>(&m_txBuffer[0]),
-                                              m_txDataLength);
+  int const transmit_result = startTransmission(reinterpret_cast<std::uint8_t const*>(&m_txBuffer[0]),
+                                                m_txDataLength);
   if (transmit_result == HAL_OK) {
     waitForTransmitCompletion();
+  }
+
+  return transmit_result;
+}
+
+int HM10::startDataTransmission(std::uint8_t const* data, std::size_t length) {
+  m_lastDataActivity = platformTicks();
+  return startTransmission(data, length);
+}
+
+int HM10::startTransmission(std::uint8_t const* data, std::size_t length) {
+  m_txInProgress = true;
+  int const transmit_result = Transport::startTransmission(UART(), data, length);
+  if (transmit_result == HAL_OK) {
+    m_statistics.transmitted(length);
+#ifdef HM10_CAPTURE
+    if (m_capture != nullptr) {
+      m_capture->record(CaptureRecordType::Transmit, data, length);
+    }
+#endif
   } else {
     transmitCompleted();
   }
@@ -758,6 +1401,15 @@ bool HM10::receiveToBuffer() {
 }
 
 bool HM10::transmitAndReceive(std::uint32_t rx_wait_time) {
+  HM10_PROFILE(m_profilingStats, ProfilingSite::TransmitAndReceive);
+  m_lastCommand = commandIndex(m_txBuffer);
+  if (!capabilities().supports(m_lastCommand)) {
+    debugLogLL("Not supported by %s firmware", capabilities().name);
+    m_statistics.commandRejected(m_lastCommand);
+    return false;
+  }
+
+  std::uint32_t const startTime = platformTicks();
   startReceivingToBuffer();
 
   if (transmitBuffer() != 0) {
@@ -767,9 +1419,14 @@ bool HM10::transmitAndReceive(std::uint32_t rx_wait_time) {
 
   if (waitForReceiveCompletion(rx_wait_time) == false) {
     debugLogLL("RX timeout");
+    m_statistics.commandTimedOut(m_lastCommand);
     return false;
   }
 
+  m_statistics.commandCompleted(m_lastCommand, platformTicks() - startTime);
+  // Any response means the module is awake - sleep() marks it asleep after OK+SLEEP
+  m_powerState = PowerState::Awake;
+  m_lastModuleActivity = platformTicks();
   return true;
 }
 
@@ -784,7 +1441,9 @@ bool HM10::transmitAndCheckResponse(char const* expectedResponse, char const* fo
     return false;
   }debugLog("Got response: %s", m_messageBuffer);
 
-  return compareWithResponse(expectedResponse);
+  bool const expected = compareWithResponse(expectedResponse);
+  m_statistics.responseChecked(m_lastCommand, expected);
+  return expected;
 }
 
 void HM10::copyCommandToBuffer(char const* commandPattern, ...) {
@@ -797,7 +1456,10 @@ void HM10::copyCommandToBuffer(char const* commandPattern, ...) {
 }
 
 void HM10::copyCommandToBufferVarg(char const* commandPattern, std::va_list args) {
-  m_txDataLength = vsnprintf(&m_txBuffer[0], bufferSize(), commandPattern, args);
+  // vsnprintf returns the length the string would have without truncation, so it has to be clamped
+  // to not transmit whatever is after the buffer
+  int const length = formatToBuffer(&m_txBuffer[0], bufferSize(), commandPattern, args);
+  m_txDataLength = (length < 0 ? 0 : std::min<std::size_t>(length, bufferSize() - 1));
 }
 
 bool HM10::compareWithResponse(char const* str) const {
@@ -805,23 +1467,34 @@ bool HM10::compareWithResponse(char const* str) const {
 }
 
 long HM10::extractNumberFromResponse(std::size_t offset, int base) const {
+  // Response can be shorter than expected, don't parse what's left in the buffer after it
+  if (offset >= m_messageLength) {
+    return 0;
+  }
   return std::strtol(&m_messageBuffer[0] + offset, nullptr, base);
 }
 
-void HM10::copyStringFromResponse(std::size_t offset, char* destination) const {
+void HM10::copyStringFromResponse(std::size_t offset, char* destination, std::size_t destinationSize) const {
+  if (destinationSize == 0) {
+    return;
+  }
+
 //  std::strcpy(destination, &m_messageBuffer[0] + offset);
   // ignore \n, \r and \0 - custom loop
-  char const* source = &m_messageBuffer[0] + offset;
-  while (*source != '\0' && *source != '\r' && *source != '\n') {
-    *destination = *source;
-    destination++;
-    source++;
+  std::size_t length { 0 };
+  if (offset < m_messageLength) {
+    char const* source = &m_messageBuffer[0] + offset;
+    while (length < destinationSize - 1 && *source != '\0' && *source != '\r' && *source != '\n') {
+      destination[length] = *source;
+      length++;
+      source++;
+    }
   }
+  destination[length] = '\0';
 }
 
 void HM10::setUARTBaudrate(std::uint32_t new_baud) const {
-  UART()->Init.BaudRate = new_baud;
-  HAL_UART_Init(UART());
+  Transport::setBaudrate(UART(), new_baud);
 }
 
 }
@@ -9,14 +9,17 @@
  * IMPORTANT: BEFORE YOU USE THIS LIBRARY, READ THIS
  * UPDATE YOUR HM-10 FIRMWARE BEFORE PLUGGING IT IN - THIS LIBRARY IS TESTED UNDER FIRMWARE V709
  * YOU CAN DOWNLOAD THE FIRMWARE AND UPDATE INSTRUCTIONS HERE: http://jnhuamao.cn/download_rom_en.asp?id=1
+ * Older firmware and clones are detected with `detectFirmware()`, and the commands they don't have fail immediately
+ * (see hm10_firmware.hpp) - but everything else is only tested on V709.
  *
- * This lib is created for usage with DMA, interrupts and RTOS. To use it without DMA, and/or without interrupts,
- * you have to re-write the `transmitBuffer` and `receiveToBuffer` methods. You'd also have to do that if you'd
- * want to port it to HAL_LL or registers, if you are into that kind of thing.
+ * This lib is created for usage with DMA, interrupts and RTOS. All the UART and DMA access goes through
+ * the transport policy picked at compile time (hm10_transport.hpp) - HAL (default) or registers. To use it without
+ * DMA, and/or without interrupts, or on a different MCU family, write your own transport.
  * If you want to ditch RTOS, you're welcome to do so, but most of the functions in this library are blocking with RTOS delays.
  * This means that the recommended way to use this library is to create a thread solely for HM-10 communication, connect
  * it to the rest of the program with message queues, and let it run there. This lib will use osDelay to give CPU time to
  * other RTOS threads when it's busy waiting for HM-10 response. If you won't use RTOS, then the delays will block the whole CPU.
+ * HM10Service (hm10_service.hpp) does exactly that - it runs the module in its own task and takes requests from a queue.
  *
  * This library also uses idle-line UART interrupt, so if your hardware for some reason does not support it,
  * then you have to find a workaround (the only reasonable way is probably a timeout, which will drastically
@@ -28,6 +31,10 @@
 #include <cstdint>
 #include <cstdarg>
 #include "hm10_constants.hpp"
+#include "hm10_firmware.hpp"
+#include "hm10_profiling.hpp"
+#include "hm10_statistics.hpp"
+#include "hm10_capture.hpp"
 
 // Re-define it somewhere in your code if you want to have different buffer size.
 // I could use a template, but it'd be basically the same in most scenarios, and there's
@@ -36,18 +43,38 @@
 #define HM10_BUFFER_SIZE 128
 #endif
 
+// Events waiting for the deferred callbacks (see CallbackDispatch), every one takes HM10_BUFFER_SIZE bytes.
+#ifndef HM10_DEFERRED_EVENT_COUNT
+#define HM10_DEFERRED_EVENT_COUNT 4
+#endif
+
+// With auto sleep enabled, the module isn't assumed to be awake after this many ms without any message from it.
+// HM-10 doesn't document its idle time, so it's kept short - the AT probe in `wakeUp()` costs a few ms.
+#ifndef HM10_AUTO_SLEEP_IDLE_TIME
+#define HM10_AUTO_SLEEP_IDLE_TIME 100
+#endif
+
 // Comment it out if you're not using RTOS (not recommended!)
 #define USE_RTOS_DELAY
 
 #ifdef USE_RTOS_DELAY
 #include <cmsis_os2.h>
+#include <FreeRTOS.h>
+#include <stream_buffer.h>
+#include <message_buffer.h>
+#include <timers.h>
 #define platformDelay osDelay
+#define platformTicks osKernelGetTickCount
 #else
 #define platformDelay HAL_Delay
+#define platformTicks HAL_GetTick
 #endif
 
 namespace HM10 {
 
+class BeaconTable;
+class EventBus;
+
 class HM10 {
 public:
   // V7xx firmware changed the default baudrate to 115200.
@@ -68,26 +95,74 @@ public:
 
   // This callback will be automatically called when the module will receive the data
   // after connecting to master.
-  void setDataCallback(DataCallbackT callback);
+  // Callbacks are called from the UART interrupt by default. With CallbackDispatch::Deferred, the event is copied
+  // and the callback runs in the timer service task instead, where it must not block (see CallbackDispatch).
+  // Events that don't fit (HM10_DEFERRED_EVENT_COUNT waiting already, or full timer queue) are dropped
+  // and counted in `linkStatistics().droppedEvents`.
+  // Deferred dispatch needs RTOS (configUSE_TIMERS and INCLUDE_xTimerPendFunctionCall), without it every
+  // callback is called from the interrupt.
+  void setDataCallback(DataCallbackT callback, CallbackDispatch dispatch = CallbackDispatch::Interrupt);
 
   // This callback will be automatically called when a new device connects
-  void setDeviceConnectedCallback(DeviceConnectedT callback);
+  void setDeviceConnectedCallback(DeviceConnectedT callback, CallbackDispatch dispatch = CallbackDispatch::Interrupt);
 
   // This callback will be automatically called when a device disconnects
-  void setDeviceDisconnectedCallback(DeviceDisconnectedT callback);
+  void setDeviceDisconnectedCallback(DeviceDisconnectedT callback,
+                                     CallbackDispatch dispatch = CallbackDispatch::Interrupt);
+
+#ifdef USE_RTOS_DELAY
+  // Events are also published to `eventBus` (see hm10_events.hpp), for any amount of listeners.
+  // nullptr detaches the bus.
+  void setEventBus(EventBus* eventBus);
+
+  // Received application data is also written to these buffers (from the UART interrupt), so a task can block
+  // on xStreamBufferReceive/xMessageBufferReceive instead of polling a flag set in the data callback.
+  // Stream buffer gets a byte stream (frame boundaries are lost), message buffer gets every frame as a separate
+  // message. Data that doesn't fit is dropped and counted in `linkStatistics().droppedDataBytes`.
+  // The driver is the only writer, nullptr detaches the buffer.
+  void setDataStreamBuffer(StreamBufferHandle_t buffer);
+  void setDataMessageBuffer(MessageBufferHandle_t buffer);
+#endif
 
   // Initializes the module communication (enables UART idle line interrupt and starts the receive procedure)
   // In order for this library to work correct, you have to call transmitCompleted IN IDLE LINE INTERRUPT HANDLER.
   // Since HAL does not support it out-of-the-box, you have to handle it manually in USARTx_IRQHandler().
   // RX DMA channel must run in circular mode.
   // See the example in repository (branch `example`) to see how to do that.
-  int initialize();
+  // With `detectFirmware`, the module is probed for its firmware variant (see `detectFirmware`). The module should
+  // be powered and at the MCU baudrate already - if it doesn't answer, the firmware stays unknown, and initialize
+  // takes ~400ms longer. Off by default, the probe can be done later, once the module is known to answer.
+  int initialize(bool detectFirmware = false);
 
   // Interrupt handler methods, use them to notify about RX/TX completion.
-  // Call `receiveCompleted` in idle line interrupt handler.
+  // Call `idleLineDetected` in idle line interrupt handler - it ends the message according to `frameBoundary()`.
+  // `receiveCompleted` ends the message unconditionally.
   // Call `transmitCompleted` in standard transmit completion handler.
+  void idleLineDetected();
   void receiveCompleted();
   void transmitCompleted();
+  // Call `errorOccurred` in HAL_UART_ErrorCallback. It records the error, and if it stopped the reception
+  // (HAL aborts RX DMA on every receive error), restarts it right away - see `linkStatistics().rxRestarts`.
+  void errorOccurred();
+
+  // Idle line fires after one character time of silence, so a reply sent with small gaps comes in fragments,
+  // each one handled as a separate message. Timeout waits `timeoutTicks` timerTick periods of silence instead
+  // (the idle line interrupt is disabled then), Terminator waits for the terminator (see `setFrameTerminator`).
+  // STM32F4 USART has no hardware receiver timeout, timerTick is the software one.
+  void setFrameBoundary(FrameBoundary boundary, std::uint32_t timeoutTicks = 2);
+  FrameBoundary frameBoundary() const;
+  // Up to 3 characters, "\r\n" by default
+  void setFrameTerminator(char const* terminator);
+  // Call it periodically (e.g. 1kHz TIM update interrupt) for Timeout and Terminator frame boundaries.
+  // It must not preempt the UART interrupt (and the other way around) - give them the same priority.
+  void timerTick();
+
+#ifdef HM10_PROFILING
+  // Execution time of interrupt handlers and command round trips (see hm10_profiling.hpp).
+  // Safe to call from any task, the copy is taken with interrupts disabled.
+  ProfilingStatistics stats() const;
+  void resetStats();
+#endif
 
   // This function will return `true` if HM10 is busy doing something (haven't processed the command yet
   // or is in busy state).
@@ -107,6 +182,29 @@ public:
   // Returns MAC address of a master device
   MACAddress masterMAC() const;
 
+  // Returns the amount of application data bytes received since the object was created.
+  // Connection messages (OK+CONN, OK+LOST) are not counted.
+  std::uint32_t receivedDataBytes() const;
+
+  // Returns the tick (platformTicks) of the last application data transfer (in any direction)
+  std::uint32_t lastDataActivity() const;
+
+  // Returns the tick (platformTicks) when the last connection was lost (OK+LOST), 0 if it never happened
+  std::uint32_t linkLostTime() const;
+
+  // Per-command statistics (see hm10_statistics.hpp), by command name ("NAME" or "AT+NAME") or index.
+  // Lock-free, can be called from any task.
+  CommandStatistics commandStatistics(char const* command) const;
+  CommandStatistics commandStatistics(std::size_t index) const;
+  // UART data path statistics, lock-free
+  LinkStatistics linkStatistics() const;
+  void resetStatistics();
+
+#ifdef HM10_CAPTURE
+  // Records the UART traffic into `capture` (see hm10_capture.hpp), nullptr stops the recording
+  void setCapture(Capture* capture);
+#endif
+
   // Send `AT` to check if the module is alive and communication is working
   // Returns `true` if module responds OK, `false` on any error
   bool isAlive();
@@ -216,7 +314,8 @@ public:
   ModulePower modulePower();
   bool setModulePower(ModulePower new_power);
 
-  // Get/set module sleep type
+  // Get/set module sleep type. The state is cached for `powerState()` - with auto sleep enabled,
+  // the module goes back to sleep by itself.
   bool autoSleep();
   bool setAutoSleep(bool enabled);
 
@@ -234,8 +333,19 @@ public:
   // Make module go to sleep
   bool sleep();
 
-  // Wake the module up
-  bool wakeUp();
+  // Wake the module up. Sends a long character burst (required by the module to wake up)
+  // and waits for OK+WAKE up to `timeout` ms. Returns immediately if the module is known to be awake.
+  // If the state is unknown, checks it with AT first (up to 100 ms) - awake module ignores the burst.
+  // If UART shutdown on sleep is enabled, the module can't be woken up through UART - in that case
+  // this function fails immediately (use system KEY pin instead).
+  bool wakeUp(std::uint32_t timeout = 1000);
+
+  // Power state tracked by the library. Any response or message from the module means it's awake,
+  // but with auto sleep enabled, it becomes Unknown after HM10_AUTO_SLEEP_IDLE_TIME without them.
+  PowerState powerState() const;
+
+  // Time (in ms) between the start of wake up burst and OK+WAKE during the last successful wake up
+  std::uint32_t wakeUpLatency() const;
 
   // Get/set the bonding mode
   BondMode bondingMode();
@@ -252,9 +362,50 @@ public:
   // Set module advertisement data (max 12-byte hex string)
   bool setAdvertisementData(char const* data);
 
+  // Reads every setting of the module (and the UART baudrate) into `blob` (see hm10_config.hpp for the format).
+  // Returns the blob length, or 0 if `size` is smaller than ConfigurationBlobSize or any setting couldn't be read.
+  std::size_t snapshot(std::uint8_t* blob, std::size_t size);
+  // Writes the settings from the blob, but only the ones that differ from the current module settings.
+  // Most of the settings are applied by the module after reboot - with `rebootAfterChanges` the module is rebooted
+  // if anything has changed (changing the baudrate always reboots it).
+  // Returns the amount of changed settings, or -1 if the blob is invalid or any command failed.
+  int restore(std::uint8_t const* blob, std::size_t length, bool rebootAfterChanges = true);
+
   // Get firmware version
   Version firmwareVersion();
 
+  // Probes the firmware variant (AT+VERR?, then AT+VERSION for clones) and selects its command table.
+  // Commands missing from the table fail without transmitting. Takes up to ~400ms if the module doesn't answer,
+  // then the firmware is `Firmware::Unknown` and every command is allowed. Called by `initialize(true)`.
+  Firmware detectFirmware();
+  Firmware firmware() const;
+  FirmwareCapabilities const& capabilities() const;
+  // By command name ("NAME" or "AT+NAME"), commands unknown to the driver are always supported
+  bool supports(char const* command) const;
+
+  // Get RSSI of current connection, in dBm. Returns 0 on error (valid RSSI is always negative).
+  // While connected, UART input goes over the link (only a bare "AT" is handled locally, and drops it), so
+  // AT+RSSI? is a remote query: the peer must be an HM-10 in remote control mode (AT+MODE2), it answers with
+  // OK+RSSI:-XXX. Any other peer gets "AT+RSSI?" as data, and the call fails on the response timeout.
+  int rssi();
+
+  // Connect to a peripheral with specified MAC address (12 hex characters).
+  // Works only in central role, with automatic mode disabled (see `setAutomaticMode`).
+  // Blocks until the connection is established, refused by the module, or `timeout` (in ms) passes.
+  bool connect(char const* address, std::uint32_t timeout = 10000);
+
+  // Connect to the last connected device (AT+CONNL) - the module remembers its address, so there's no scan.
+  // Same requirements and blocking as `connect`. Fails right away if the module has no last address.
+  bool connectLast(std::uint32_t timeout = 10000);
+
+  // Drop the current connection. Returns `true` if the module is not connected anymore.
+  bool disconnect();
+
+  // Scan for iBeacons (AT+DISI?) and store the results in `table`. Works only in central role,
+  // with automatic mode disabled. Blocks until the scan is finished or `timeout` (in ms) passes.
+  // Data and connection callbacks are not called during the scan.
+  bool discoverBeacons(BeaconTable& table, std::uint32_t timeout = 10000);
+
   // Send data to connected device
   // Returns 'false' if module is not connected.
   // This function is blocking the thread by default.
@@ -270,9 +421,59 @@ public:
   bool printf(char const* fmt, ...);
 
 private:
-  bool handleConnectionMessage();
+#ifdef HM10_HOST_BUILD
+  // Host tools (benchmarks, fuzzers) need to reach the internals
+  friend struct HostAccess;
+#endif
+  // Coroutine front end (hm10_coroutine.hpp) drives the transfers without blocking
+  friend class AsyncHM10;
+
+  // Called from interrupts, when the response is received or transmission is completed
+  using CompletionCallbackT = void(*)(void*);
+
+  // Callback event copied in the interrupt, for the deferred dispatch
+  struct DeferredEvent {
+    enum class Type : std::uint8_t {
+      Data, Connected, Disconnected
+    };
+
+    Type type;
+    std::size_t length;
+    // Data, or MAC address of the connected device
+    char data[HM10_BUFFER_SIZE];
+  };
+
+  // `fromInterrupt` is false when a task handles the message (OK+LOST in response to `disconnect()`)
+  bool handleConnectionMessage(bool fromInterrupt);
+  // Waits for the result of the connection started with AT+CON or AT+CONNL
+  bool waitForConnection(std::uint32_t timeout);
+  // Reads the settings into the blob payload (without the header and CRC)
+  bool readConfiguration(std::uint8_t* payload);
+  // Restarts RX DMA after an error and resynchronizes the message start with it
+  void restartReception();
+  // Where DMA will write the next received byte
+  char* dmaWritePointer();
+  // Checks if the data received since the last message ends with the terminator
+  bool frameTerminated();
+  // Idle line interrupt is needed by every frame boundary except Timeout
+  void applyFrameBoundary();
+#ifdef USE_RTOS_DELAY
+  // Writes the received data to the stream/message buffers, called from interrupts
+  void forwardData(char const* data, std::size_t length);
+#endif
+  // Queues the callback event when `dispatch` is Deferred. Returns false if the callback should be called right away.
+  // `fromInterrupt` picks the FreeRTOS API variant for pending the dispatch.
+  bool deferCallback(CallbackDispatch dispatch, DeferredEvent::Type type, char const* data, std::size_t length,
+                     bool fromInterrupt);
+#ifdef USE_RTOS_DELAY
+  // Timer service task function (PendedFunction_t), calls the callbacks of all the queued events
+  static void dispatchDeferredEvents(void* module, std::uint32_t);
+#endif
 
   int transmitBuffer();
+  // Start the DMA transmission and return without waiting for it
+  int startTransmission(std::uint8_t const* data, std::size_t length);
+  int startDataTransmission(std::uint8_t const* data, std::size_t length);
   void waitForTransmitCompletion() const;
 
   void startReceivingToBuffer();
@@ -289,7 +490,13 @@ private:
 
   // Most of the command responses are OK+Get: so the default offset it 7
   long extractNumberFromResponse(std::size_t offset = 7, int base = 10) const;
-  void copyStringFromResponse(std::size_t offset, char* destination) const;
+  // Copies until the end of line, always null-terminates and never writes more than destinationSize bytes
+  void copyStringFromResponse(std::size_t offset, char* destination, std::size_t destinationSize) const;
+
+  template <std::size_t N>
+  void copyStringFromResponse(std::size_t offset, char (&destination)[N]) const {
+    copyStringFromResponse(offset, destination, N);
+  }
 
   void setUARTBaudrate(std::uint32_t new_baud) const;
 
@@ -309,6 +516,14 @@ private:
   char* m_msgStartPtr { &m_rxBuffer[0] };
   char const* m_rxBufferEnd { &m_rxBuffer[0] + HM10_BUFFER_SIZE };
 
+  FrameBoundary m_frameBoundary { FrameBoundary::IdleLine };
+  std::uint32_t m_frameTimeoutTicks { 2 };
+  char m_terminator[4] { '\r', '\n' };
+  std::size_t m_terminatorLength { 2 };
+  // DMA position at the previous timerTick, and for how many ticks it hasn't moved
+  char const* m_lastWritePtr { nullptr };
+  std::uint32_t m_silentTicks { 0 };
+
   bool m_rxInProgress { false };
   bool m_txInProgress { false };
 
@@ -318,13 +533,61 @@ private:
   Baudrate m_newBaudrate { DefaultBaudrate };
 
   bool m_isConnected { false };
+  bool m_connectionFailed { false };
   MACAddress m_connectedMAC { };
+  std::uint32_t m_receivedDataBytes { 0 };
+  std::uint32_t m_lastDataActivity { 0 };
+  std::uint32_t m_linkLostTime { 0 };
+
+  // Set only during the beacon scan, all the received messages go there
+  BeaconTable* m_beaconTable { nullptr };
 
   DataCallbackT m_dataCallback { nullptr };
   DeviceConnectedT m_deviceConnectedCallback { nullptr };
   DeviceDisconnectedT m_deviceDisconnectedCallback { nullptr };
+  CallbackDispatch m_dataDispatch { CallbackDispatch::Interrupt };
+  CallbackDispatch m_deviceConnectedDispatch { CallbackDispatch::Interrupt };
+  CallbackDispatch m_deviceDisconnectedDispatch { CallbackDispatch::Interrupt };
+#ifdef USE_RTOS_DELAY
+  // Ring of deferred events - written in the interrupt at `head`, taken by the timer service task from the tail
+  DeferredEvent m_deferredEvents[HM10_DEFERRED_EVENT_COUNT] { };
+  std::size_t m_deferredHead { 0 };
+  std::size_t m_deferredCount { 0 };
+  // Set while the dispatch is pended or running - it takes every event queued until it finds the queue empty
+  bool m_dispatchScheduled { false };
+  EventBus* m_eventBus { nullptr };
+  StreamBufferHandle_t m_dataStreamBuffer { nullptr };
+  MessageBufferHandle_t m_dataMessageBuffer { nullptr };
+#endif
 
   bool m_rfCommMode { false };
+
+  PowerState m_powerState { PowerState::Unknown };
+  // UART shutdown on sleep state is cached on every get/set, so wakeUp can tell if it's possible
+  bool m_uartShutdownKnown { false };
+  bool m_uartShutdownOnSleep { false };
+  // Auto sleep (AT+PWRM0) state, cached on every get/set
+  bool m_autoSleep { false };
+  // Tick of the last response or message from the module
+  std::uint32_t m_lastModuleActivity { 0 };
+  std::uint32_t m_wakeUpLatency { 0 };
+
+  Firmware m_firmware { Firmware::Unknown };
+
+  CompletionCallbackT m_completionCallback { nullptr };
+  void* m_completionContext { nullptr };
+
+  Statistics m_statistics { };
+  // Index of the last command sent via transmitAndReceive, for response statistics
+  std::size_t m_lastCommand { UnknownCommand };
+
+#ifdef HM10_PROFILING
+  ProfilingStatistics m_profilingStats { };
+#endif
+
+#ifdef HM10_CAPTURE
+  Capture* m_capture { nullptr };
+#endif
 };
 
 }
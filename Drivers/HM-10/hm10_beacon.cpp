@@ -0,0 +1,271 @@
+/*
+ * hm10_beacon.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_beacon.hpp"
+
+#include <cstring>
+
+namespace HM10 {
+
+namespace {
+
+constexpr char LinePrefix[] { "OK+DISC" };
+constexpr std::size_t LinePrefixLength { sizeof(LinePrefix) - 1 };
+
+// Offsets of the fields in OK+DISC:FFFFFFFF:UUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUU:MMMMmmmmPP:AAAAAAAAAAAA:-RRR
+constexpr std::size_t FactoryIdOffset { 8 };
+constexpr std::size_t UUIDOffset { 17 };
+constexpr std::size_t MajorOffset { 50 };
+constexpr std::size_t MinorOffset { 54 };
+constexpr std::size_t PowerOffset { 58 };
+constexpr std::size_t MACOffset { 61 };
+constexpr std::size_t RSSIOffset { 74 };
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+// Converts `bytes` bytes from hex string. Returns false on invalid character.
+bool parseHex(char const* text, std::uint8_t* output, std::size_t bytes) {
+  for (std::size_t i = 0; i < bytes; i++) {
+    int const high = hexValue(text[2 * i]);
+    int const low = hexValue(text[2 * i + 1]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    output[i] = static_cast<std::uint8_t>((high << 4) | low);
+  }
+  return true;
+}
+
+std::uint32_t hashMAC(std::uint8_t const* mac) {
+  // FNV-1a
+  std::uint32_t hash { 2166136261u };
+  for (std::size_t i = 0; i < 6; i++) {
+    hash ^= mac[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+}
+
+void BeaconTable::ingest(char const* data, std::size_t length, std::uint32_t timestamp) {
+  // Byte-by-byte state machine, so the lines split between UART chunks don't need any special treatment.
+  // Everything that is not a part of OK+DISC line is skipped.
+  for (std::size_t i = 0; i < length; i++) {
+    char const c = data[i];
+
+    if (m_partialLength < LinePrefixLength) {
+      if (c == LinePrefix[m_partialLength]) {
+        m_partialLine[m_partialLength++] = c;
+      } else {
+        m_partialLength = (c == LinePrefix[0] ? 1 : 0);
+        m_partialLine[0] = c;
+      }
+      continue;
+    }
+
+    if (m_partialLength == LinePrefixLength) {
+      if (c == 'E') {
+        // OK+DISCE - end of the scan
+        m_scanFinished = true;
+        m_partialLength = 0;
+        continue;
+      } else if (c != ':') {
+        m_partialLength = (c == LinePrefix[0] ? 1 : 0);
+        continue;
+      }
+    }
+
+    m_partialLine[m_partialLength++] = c;
+    if (m_partialLength == LineLength) {
+      if (!parseLine(m_partialLine, timestamp)) {
+        m_malformedLines++;
+      }
+      m_partialLength = 0;
+    }
+  }
+}
+
+void BeaconTable::beginScan() {
+  m_scanFinished = false;
+  m_partialLength = 0;
+}
+
+bool BeaconTable::scanFinished() const {
+  return m_scanFinished;
+}
+
+BeaconRecord const* BeaconTable::find(std::uint8_t const* mac) const {
+  std::size_t const slot = slotOf(mac);
+  if (slot < Capacity && m_used[slot] && std::memcmp(m_records[slot].mac, mac, 6) == 0) {
+    return &m_records[slot];
+  }
+  return nullptr;
+}
+
+BeaconRecord const* BeaconTable::find(char const* mac) const {
+  std::uint8_t binaryMAC[6];
+  if (std::strlen(mac) != 12 || !parseHex(mac, binaryMAC, 6)) {
+    return nullptr;
+  }
+  return find(binaryMAC);
+}
+
+std::size_t BeaconTable::removeOlderThan(std::uint32_t timestamp) {
+  std::size_t removed { 0 };
+  for (std::size_t slot = 0; slot < Capacity; slot++) {
+    // Erasing shifts the following records back, so the same slot has to be checked again
+    while (m_used[slot] && static_cast<std::int32_t>(m_records[slot].lastSeen - timestamp) < 0) {
+      erase(slot);
+      removed++;
+    }
+  }
+  return removed;
+}
+
+void BeaconTable::clear() {
+  std::memset(m_used, 0, sizeof(m_used));
+  m_size = 0;
+  m_droppedSightings = 0;
+  m_malformedLines = 0;
+  beginScan();
+}
+
+std::size_t BeaconTable::size() const {
+  return m_size;
+}
+
+std::uint32_t BeaconTable::droppedSightings() const {
+  return m_droppedSightings;
+}
+
+std::uint32_t BeaconTable::malformedLines() const {
+  return m_malformedLines;
+}
+
+BeaconRecord const* BeaconTable::at(std::size_t slot) const {
+  if (slot < Capacity && m_used[slot]) {
+    return &m_records[slot];
+  }
+  return nullptr;
+}
+
+bool BeaconTable::parseLine(char const* line, std::uint32_t timestamp) {
+  if (line[FactoryIdOffset + 8] != ':' || line[UUIDOffset + 32] != ':' || line[PowerOffset + 2] != ':'
+      || line[MACOffset + 12] != ':' || line[RSSIOffset] != '-') {
+    return false;
+  }
+
+  BeaconRecord record { };
+  std::uint8_t numbers[5];
+  if (!parseHex(&line[UUIDOffset], record.uuid, 16) || !parseHex(&line[MajorOffset], numbers, 5)
+      || !parseHex(&line[MACOffset], record.mac, 6)) {
+    return false;
+  }
+
+  record.major = static_cast<std::uint16_t>((numbers[0] << 8) | numbers[1]);
+  record.minor = static_cast<std::uint16_t>((numbers[2] << 8) | numbers[3]);
+  record.txPower = static_cast<std::int8_t>(numbers[4]);
+
+  int rssi { 0 };
+  for (std::size_t i = RSSIOffset + 1; i < LineLength; i++) {
+    if (line[i] < '0' || line[i] > '9') {
+      return false;
+    }
+    rssi = rssi * 10 + (line[i] - '0');
+  }
+  if (rssi > 128) {
+    return false;
+  }
+
+  record.lastRSSI = static_cast<std::int8_t>(-rssi);
+  record.rssiAverage = static_cast<std::int16_t>(record.lastRSSI * 16);
+  record.sightings = 1;
+  record.lastSeen = timestamp;
+
+  insert(record);
+  return true;
+}
+
+void BeaconTable::insert(BeaconRecord const& record) {
+  std::size_t const slot = slotOf(record.mac);
+  if (slot >= Capacity) {
+    m_droppedSightings++;
+    return;
+  }
+
+  if (!m_used[slot]) {
+    m_records[slot] = record;
+    m_used[slot] = true;
+    m_size++;
+    return;
+  }
+
+  // Duplicate - merge it
+  BeaconRecord& existing = m_records[slot];
+  int const average = existing.rssiAverage;
+  existing.rssiAverage = static_cast<std::int16_t>(average
+                                                   + (record.rssiAverage - average) / (1 << HM10_BEACON_RSSI_EWMA_SHIFT));
+  existing.lastRSSI = record.lastRSSI;
+  existing.lastSeen = record.lastSeen;
+  existing.major = record.major;
+  existing.minor = record.minor;
+  existing.txPower = record.txPower;
+  std::memcpy(existing.uuid, record.uuid, sizeof(existing.uuid));
+  if (existing.sightings < UINT16_MAX) {
+    existing.sightings++;
+  }
+}
+
+// Returns the slot with specified MAC, or the first free slot in its probe sequence.
+// Capacity is returned if the table is full and MAC is not in it.
+std::size_t BeaconTable::slotOf(std::uint8_t const* mac) const {
+  std::size_t slot = hashMAC(mac) & (Capacity - 1);
+  for (std::size_t probe = 0; probe < Capacity; probe++) {
+    if (!m_used[slot] || std::memcmp(m_records[slot].mac, mac, 6) == 0) {
+      return slot;
+    }
+    slot = (slot + 1) & (Capacity - 1);
+  }
+  return Capacity;
+}
+
+void BeaconTable::erase(std::size_t slot) {
+  // Backward-shift deletion - no tombstones, so the lookups stay short
+  m_used[slot] = false;
+  m_size--;
+
+  std::size_t hole = slot;
+  std::size_t next = slot;
+  while (true) {
+    next = (next + 1) & (Capacity - 1);
+    if (!m_used[next]) {
+      return;
+    }
+
+    std::size_t const home = hashMAC(m_records[next].mac) & (Capacity - 1);
+    // Move the record if its home slot is not between the hole and its current position (cyclically)
+    bool const homeBetween = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+    if (!homeBetween) {
+      m_records[hole] = m_records[next];
+      m_used[hole] = true;
+      m_used[next] = false;
+      hole = next;
+    }
+  }
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+ * hm10_beacon.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * iBeacon discovery results storage.
+ * HM-10 reports every sighting as a ~78 character text line (`OK+DISC:factory:UUID:major/minor/power:MAC:RSSI`),
+ * and in dense deployments the same beacons repeat many times during a single scan.
+ * This table parses those lines into compact binary records, stored in fixed-size open-addressing
+ * hash table keyed by MAC address. Repeated sightings are merged - RSSI is averaged (EWMA) and
+ * the last-seen timestamp is updated.
+ *
+ * Usage: create a table, and pass it to `HM10::discoverBeacons`. The module must be in central role
+ * with automatic mode disabled.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Amount of records in the table. Must be a power of 2.
+#ifndef HM10_BEACON_TABLE_SIZE
+#define HM10_BEACON_TABLE_SIZE 32
+#endif
+
+// RSSI average weight is 1/2^HM10_BEACON_RSSI_EWMA_SHIFT (default: new sample = 1/4 of the average)
+#ifndef HM10_BEACON_RSSI_EWMA_SHIFT
+#define HM10_BEACON_RSSI_EWMA_SHIFT 2
+#endif
+
+namespace HM10 {
+
+struct BeaconRecord {
+  std::uint8_t uuid[16];
+  std::uint8_t mac[6];
+  std::uint16_t major;
+  std::uint16_t minor;
+  // Measured power (RSSI at 1m) advertised by the beacon
+  std::int8_t txPower;
+  std::int8_t lastRSSI;
+  // RSSI average, in 1/16 dBm
+  std::int16_t rssiAverage;
+  std::uint16_t sightings;
+  std::uint32_t lastSeen;
+
+  int averageRSSI() const {
+    return rssiAverage / 16;
+  }
+};
+
+class BeaconTable {
+public:
+  static constexpr std::size_t Capacity { HM10_BEACON_TABLE_SIZE };
+  static_assert((Capacity & (Capacity - 1)) == 0, "HM10_BEACON_TABLE_SIZE must be a power of 2");
+
+  // Length of a single discovery line (OK+DISC:...)
+  static constexpr std::size_t LineLength { 78 };
+
+  // Parse the chunk of AT+DISI? output. Lines split between chunks are joined.
+  // `timestamp` is stored as last-seen time of every beacon found in the chunk.
+  void ingest(char const* data, std::size_t length, std::uint32_t timestamp);
+
+  // Marks the start of a new scan (clears the scan state, but not the records)
+  void beginScan();
+  // `true` after OK+DISCE has been received
+  bool scanFinished() const;
+
+  // Find the record by binary (6-byte) or text (12 hex characters) MAC address
+  BeaconRecord const* find(std::uint8_t const* mac) const;
+  BeaconRecord const* find(char const* mac) const;
+
+  // Remove the records that weren't seen since `timestamp`. Returns amount of removed records.
+  std::size_t removeOlderThan(std::uint32_t timestamp);
+  void clear();
+
+  std::size_t size() const;
+  // Amount of sightings dropped because the table was full
+  std::uint32_t droppedSightings() const;
+  // Amount of lines that couldn't be parsed
+  std::uint32_t malformedLines() const;
+
+  // Iterate over used records with `for (std::size_t i = 0; i < Capacity; i++) if (auto r = at(i))`
+  BeaconRecord const* at(std::size_t slot) const;
+
+private:
+  bool parseLine(char const* line, std::uint32_t timestamp);
+  void insert(BeaconRecord const& record);
+  std::size_t slotOf(std::uint8_t const* mac) const;
+  void erase(std::size_t slot);
+
+  BeaconRecord m_records[Capacity] { };
+  bool m_used[Capacity] { };
+  std::size_t m_size { 0 };
+
+  // Part of the line from the end of previous chunk
+  char m_partialLine[LineLength] { };
+  std::size_t m_partialLength { 0 };
+
+  bool m_scanFinished { false };
+  std::uint32_t m_droppedSightings { 0 };
+  std::uint32_t m_malformedLines { 0 };
+};
+
+}
@@ -0,0 +1,100 @@
+/*
+ * hm10_capture.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_capture.hpp"
+
+#ifdef HM10_CAPTURE
+#include "hm10.hpp"
+#include "hm10_platform.hpp"
+#include <cstring>
+
+namespace HM10 {
+
+namespace {
+
+constexpr std::size_t Mask { HM10_CAPTURE_BUFFER_SIZE - 1 };
+constexpr char Magic[8] { 'H', 'M', '1', '0', 'C', 'A', 'P', '\0' };
+
+std::uint32_t timestampFrequency() {
+#ifdef USE_RTOS_DELAY
+  return osKernelGetTickFreq();
+#else
+  return 1000;
+#endif
+}
+
+}
+
+void Capture::header(std::uint8_t (&destination)[HeaderSize]) {
+  std::uint32_t const frequency = timestampFrequency();
+  std::memset(destination, 0, HeaderSize);
+  std::memcpy(&destination[0], Magic, sizeof(Magic));
+  destination[8] = Version;
+  std::memcpy(&destination[12], &frequency, sizeof(frequency));
+}
+
+void Capture::record(CaptureRecordType type, void const* data, std::size_t length) {
+  if (length > 0xFFFF) {
+    length = 0xFFFF;
+  }
+
+  std::uint8_t header[RecordHeaderSize] { };
+  std::uint32_t const timestamp = platformTicks();
+  std::uint16_t const recordLength = static_cast<std::uint16_t>(length);
+  header[0] = static_cast<std::uint8_t>(type);
+  std::memcpy(&header[1], &timestamp, sizeof(timestamp));
+  std::memcpy(&header[5], &recordLength, sizeof(recordLength));
+
+  CriticalSection const criticalSection { };
+  if (HM10_CAPTURE_BUFFER_SIZE - (m_head - m_tail) < RecordHeaderSize + length) {
+    m_dropped++;
+    return;
+  }
+  push(header, RecordHeaderSize);
+  push(static_cast<std::uint8_t const*>(data), length);
+}
+
+std::size_t Capture::read(std::uint8_t* destination, std::size_t maxLength) {
+  std::size_t copied { 0 };
+  while (true) {
+    // One record at a time, so the interrupts are never masked for long
+    CriticalSection const criticalSection { };
+    if (m_head == m_tail) {
+      break;
+    }
+
+    std::uint16_t const dataLength = m_buffer[(m_tail + 5) & Mask]
+                                     | (m_buffer[(m_tail + 6) & Mask] << 8);
+    std::size_t const length = RecordHeaderSize + dataLength;
+    if (copied + length > maxLength) {
+      break;
+    }
+
+    for (std::size_t i = 0; i < length; i++) {
+      destination[copied + i] = m_buffer[(m_tail + i) & Mask];
+    }
+    m_tail += length;
+    copied += length;
+  }
+  return copied;
+}
+
+std::uint32_t Capture::droppedRecords() const {
+  CriticalSection const criticalSection { };
+  return m_dropped;
+}
+
+void Capture::push(std::uint8_t const* data, std::size_t length) {
+  for (std::size_t i = 0; i < length; i++) {
+    m_buffer[(m_head + i) & Mask] = data[i];
+  }
+  m_head += length;
+}
+
+}
+
+#endif
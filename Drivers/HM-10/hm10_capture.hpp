@@ -0,0 +1,76 @@
+/*
+ * hm10_capture.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * UART session capture, enabled with HM10_CAPTURE.
+ * Attach a `Capture` object with `HM10::setCapture`, and the driver will record every transmitted buffer
+ * and every received message (one record per idle line, so the frame boundaries are kept).
+ * Recording is done from interrupts too, so it's just a copy into the ring buffer - drain it from a task
+ * with `read()` and store it somewhere (SD card, debug UART...). Host/Tools/hm10_replay feeds the capture
+ * back to the driver.
+ *
+ * Capture file format (little endian):
+ *   header: "HM10CAP" + '\0', u8 version, 3 reserved bytes, u32 timestamp frequency (Hz)
+ *   records: u8 type (CaptureRecordType), u32 timestamp, u16 length, data
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#ifdef HM10_CAPTURE
+
+// Size of the capture ring buffer, must be a power of 2
+#ifndef HM10_CAPTURE_BUFFER_SIZE
+#define HM10_CAPTURE_BUFFER_SIZE 4096
+#endif
+
+namespace HM10 {
+
+enum class CaptureRecordType : std::uint8_t {
+  Transmit = 0,
+  // Message that came when the driver wasn't waiting for a response (connection messages, data)
+  Receive = 1,
+  // Message received as a response to a command
+  Response = 2,
+  // Data is u32 HAL UART error code
+  UARTError = 3
+};
+
+static_assert((HM10_CAPTURE_BUFFER_SIZE & (HM10_CAPTURE_BUFFER_SIZE - 1)) == 0,
+              "HM10_CAPTURE_BUFFER_SIZE must be a power of 2");
+
+class Capture {
+public:
+  static constexpr std::uint8_t Version { 1 };
+  static constexpr std::size_t HeaderSize { 16 };
+  static constexpr std::size_t RecordHeaderSize { 7 };
+
+  // Writes the file header, it has to be stored before the records
+  static void header(std::uint8_t (&destination)[HeaderSize]);
+
+  // Safe to call from interrupts. If there's not enough space, the record is dropped.
+  void record(CaptureRecordType type, void const* data, std::size_t length);
+
+  // Copies whole records to `destination`, returns the amount of bytes copied
+  std::size_t read(std::uint8_t* destination, std::size_t maxLength);
+
+  std::uint32_t droppedRecords() const;
+
+private:
+  void push(std::uint8_t const* data, std::size_t length);
+
+  std::uint8_t m_buffer[HM10_CAPTURE_BUFFER_SIZE] { };
+  // Free-running indexes, modified only with interrupts masked
+  std::size_t m_head { 0 };
+  std::size_t m_tail { 0 };
+  std::uint32_t m_dropped { 0 };
+};
+
+}
+
+#endif
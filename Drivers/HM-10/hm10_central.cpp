@@ -0,0 +1,270 @@
+/*
+ * hm10_central.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_central.hpp"
+#include "hm10_debug.hpp"
+
+#include <cstring>
+#include <cctype>
+
+namespace HM10 {
+
+std::uint32_t PeripheralStats::averageConnectLatency() const {
+  std::uint32_t const connections = visits;
+  return connections > 0 ? totalConnectLatency / connections : 0;
+}
+
+std::uint32_t PollerStats::throughput() const {
+  if (elapsedTime == 0) {
+    return 0;
+  }
+  return static_cast<std::uint32_t>((static_cast<std::uint64_t>(bytesReceived) * 1000) / elapsedTime);
+}
+
+CentralPoller::CentralPoller(HM10& module)
+    : m_module(module) {
+}
+
+bool CentralPoller::addTarget(char const* address) {
+  if (m_targetCount >= HM10_CENTRAL_MAX_TARGETS || std::strlen(address) != 12) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < 12; i++) {
+    if (!std::isxdigit(static_cast<unsigned char>(address[i]))) {
+      return false;
+    }
+  }
+
+  if (findTarget(address) >= 0) {
+    return false;
+  }
+
+  PeripheralTarget& target = m_targets[m_targetCount];
+  target = PeripheralTarget { };
+  std::memcpy(target.mac.address, address, 12);
+  m_targetCount++;
+  return true;
+}
+
+bool CentralPoller::removeTarget(char const* address) {
+  int const index = findTarget(address);
+  if (index < 0) {
+    return false;
+  }
+
+  for (std::size_t i = index; i + 1 < m_targetCount; i++) {
+    m_targets[i] = m_targets[i + 1];
+  }
+  m_targetCount--;
+  return true;
+}
+
+void CentralPoller::clearTargets() {
+  m_targetCount = 0;
+}
+
+std::size_t CentralPoller::targetCount() const {
+  return m_targetCount;
+}
+
+PeripheralTarget const* CentralPoller::target(std::size_t index) const {
+  if (index >= m_targetCount) {
+    return nullptr;
+  }
+  return &m_targets[index];
+}
+
+void CentralPoller::setConnectTimeout(std::uint32_t timeout) {
+  m_connectTimeout = timeout;
+}
+
+void CentralPoller::setDrainDeadline(std::uint32_t deadline) {
+  m_drainDeadline = deadline;
+}
+
+void CentralPoller::setDrainIdleTime(std::uint32_t idleTime) {
+  m_drainIdleTime = idleTime;
+}
+
+void CentralPoller::setAgingDivisor(std::uint32_t divisor) {
+  m_agingDivisor = (divisor > 0 ? divisor : 1);
+}
+
+bool CentralPoller::pollNext() {
+  if (m_targetCount == 0) {
+    return false;
+  }
+
+  startPolling();
+  return visit(m_targets[selectNext(platformTicks())]);
+}
+
+std::size_t CentralPoller::pollAll() {
+  // Scores change after every visit, so `pollNext` could pick the same target twice - the order is computed once.
+  // Insertion sort is stable (never visited targets keep the table order) and the table is small.
+  std::uint32_t const now = platformTicks();
+  std::size_t order[HM10_CENTRAL_MAX_TARGETS] { };
+  std::uint32_t scores[HM10_CENTRAL_MAX_TARGETS] { };
+  for (std::size_t i = 0; i < m_targetCount; i++) {
+    std::uint32_t const targetScore = score(m_targets[i], now);
+    std::size_t position = i;
+    while (position > 0 && scores[position - 1] < targetScore) {
+      order[position] = order[position - 1];
+      scores[position] = scores[position - 1];
+      position--;
+    }
+    order[position] = i;
+    scores[position] = targetScore;
+  }
+
+  std::size_t successfulVisits { 0 };
+  startPolling();
+  for (std::size_t i = 0; i < m_targetCount; i++) {
+    if (visit(m_targets[order[i]])) {
+      successfulVisits++;
+    }
+  }
+  return successfulVisits;
+}
+
+void CentralPoller::startPolling() {
+  if (!m_pollStarted) {
+    m_firstPollTime = platformTicks();
+    m_pollStarted = true;
+  }
+}
+
+bool CentralPoller::visit(PeripheralTarget& target) {
+  debugLog("Polling %s (backlog %d)", target.mac.address, target.backlog);
+
+  // The module can be connected only to one device at a time
+  if (m_module.isConnected()) {
+    m_module.disconnect();
+  }
+
+  std::uint32_t const connectStart = platformTicks();
+  bool const connected = m_module.connect(target.mac.address, m_connectTimeout);
+  std::uint32_t const connectLatency = platformTicks() - connectStart;
+
+  if (!connected) {
+    debugLog("Connection to %s failed", target.mac.address);
+    target.stats.failedConnections++;
+    m_stats.failedConnections++;
+    // Don't retry it immediately, let the others go first
+    target.visited = true;
+    target.backlog = 0;
+    target.lastAttempt = platformTicks();
+    m_stats.elapsedTime = target.lastAttempt - m_firstPollTime;
+    return false;
+  }
+
+  PeripheralStats& stats = target.stats;
+  stats.lastConnectLatency = connectLatency;
+  stats.totalConnectLatency += connectLatency;
+  if (stats.visits == 0 || connectLatency < stats.minConnectLatency) {
+    stats.minConnectLatency = connectLatency;
+  }
+  if (connectLatency > stats.maxConnectLatency) {
+    stats.maxConnectLatency = connectLatency;
+  }
+  // Revisit time is counted between successful visits only
+  if (stats.visits > 0) {
+    stats.lastRevisitTime = connectStart - target.lastSeen;
+    if (stats.lastRevisitTime > stats.maxRevisitTime) {
+      stats.maxRevisitTime = stats.lastRevisitTime;
+    }
+  }
+  stats.visits++;
+  m_stats.visits++;
+
+  drain(target);
+  m_module.disconnect();
+
+  target.visited = true;
+  target.lastSeen = platformTicks();
+  target.lastAttempt = target.lastSeen;
+  m_stats.elapsedTime = target.lastSeen - m_firstPollTime;
+  return true;
+}
+
+PollerStats const& CentralPoller::stats() const {
+  return m_stats;
+}
+
+void CentralPoller::resetStats() {
+  m_stats = PollerStats { };
+  m_pollStarted = false;
+  for (std::size_t i = 0; i < m_targetCount; i++) {
+    m_targets[i].stats = PeripheralStats { };
+  }
+}
+
+int CentralPoller::findTarget(char const* address) const {
+  for (std::size_t i = 0; i < m_targetCount; i++) {
+    if (std::strncmp(m_targets[i].mac.address, address, 12) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+std::uint32_t CentralPoller::score(PeripheralTarget const& target, std::uint32_t now) const {
+  // Never visited targets go first, then the score is backlog + waiting time
+  if (!target.visited) {
+    return UINT32_MAX;
+  }
+  std::uint32_t const aging = (now - target.lastAttempt) / m_agingDivisor;
+  return (aging < UINT32_MAX - 1 - target.backlog ? target.backlog + aging : UINT32_MAX - 1);
+}
+
+std::size_t CentralPoller::selectNext(std::uint32_t now) const {
+  // The first one with the highest score, so the never visited targets go in the order they were added
+  std::size_t bestIndex { 0 };
+  std::uint32_t bestScore { 0 };
+
+  for (std::size_t i = 0; i < m_targetCount; i++) {
+    std::uint32_t const targetScore = score(m_targets[i], now);
+    if (i == 0 || targetScore > bestScore) {
+      bestScore = targetScore;
+      bestIndex = i;
+    }
+  }
+
+  return bestIndex;
+}
+
+void CentralPoller::drain(PeripheralTarget& target) {
+  std::uint32_t const drainStart = platformTicks();
+  std::uint32_t const bytesAtStart = m_module.receivedDataBytes();
+  std::uint32_t lastBytes = bytesAtStart;
+  std::uint32_t lastActivity = drainStart;
+
+  while (m_module.isConnected()) {
+    std::uint32_t const now = platformTicks();
+    std::uint32_t const bytes = m_module.receivedDataBytes();
+
+    if (bytes != lastBytes) {
+      lastBytes = bytes;
+      lastActivity = now;
+    }
+
+    if (now - lastActivity >= m_drainIdleTime || now - drainStart >= m_drainDeadline) {
+      break;
+    }
+
+    platformDelay(1);
+  }
+
+  std::uint32_t const received = lastBytes - bytesAtStart;
+  target.backlog = received;
+  target.stats.bytesReceived += received;
+  m_stats.bytesReceived += received;
+  m_stats.connectedTime += platformTicks() - drainStart;
+}
+
+}
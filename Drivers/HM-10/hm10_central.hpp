@@ -0,0 +1,133 @@
+/*
+ * hm10_central.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Round-robin poller for HM-10 working in central role.
+ * HM-10 can hold only one connection at a time, so the poller connects to every target peripheral,
+ * collects the data it has to send (until it goes quiet or the drain deadline passes), disconnects,
+ * and moves to the next one. The targets with the biggest backlog and the ones not visited for the longest
+ * time are visited first - by `pollNext`, and within every `pollAll` round (ordered once, at its start).
+ *
+ * Before using it, set the module to central role and disable automatic mode:
+ *   hm10.setRole(HM10::Role::Central);
+ *   hm10.setAutomaticMode(false);
+ * The data is still delivered through the data callback of HM10 object, poller only counts it.
+ */
+
+#pragma once
+#include "hm10.hpp"
+
+// Maximum amount of peripherals handled by a single poller
+#ifndef HM10_CENTRAL_MAX_TARGETS
+#define HM10_CENTRAL_MAX_TARGETS 16
+#endif
+
+namespace HM10 {
+
+// All the times are in ms (RTOS ticks)
+struct PeripheralStats {
+  std::uint32_t visits { 0 };
+  std::uint32_t failedConnections { 0 };
+  std::uint32_t bytesReceived { 0 };
+
+  std::uint32_t lastConnectLatency { 0 };
+  std::uint32_t minConnectLatency { 0 };
+  std::uint32_t maxConnectLatency { 0 };
+  std::uint32_t totalConnectLatency { 0 };
+
+  // Time between the end of previous visit and the start of current one
+  std::uint32_t lastRevisitTime { 0 };
+  std::uint32_t maxRevisitTime { 0 };
+
+  std::uint32_t averageConnectLatency() const;
+};
+
+struct PeripheralTarget {
+  MACAddress mac { };
+  // Set after the first visit attempt, successful or not
+  bool visited { false };
+  // Amount of bytes received during the last visit - used as data backlog estimate
+  std::uint32_t backlog { 0 };
+  // Tick of the last successful visit end
+  std::uint32_t lastSeen { 0 };
+  // Tick of the last visit attempt end, failed ones included - the waiting time for picking the next target
+  // is counted from it, so an unreachable peripheral isn't retried right away
+  std::uint32_t lastAttempt { 0 };
+  PeripheralStats stats { };
+};
+
+struct PollerStats {
+  std::uint32_t visits { 0 };
+  std::uint32_t failedConnections { 0 };
+  std::uint32_t bytesReceived { 0 };
+  // Time spent connected to the peripherals
+  std::uint32_t connectedTime { 0 };
+  // Time since the first poll
+  std::uint32_t elapsedTime { 0 };
+
+  // Aggregate throughput, in bytes per second
+  std::uint32_t throughput() const;
+};
+
+class CentralPoller {
+public:
+  CentralPoller(HM10& module);
+
+  // Add/remove the peripheral MAC address (12 hex characters) to/from the polling table.
+  // `addTarget` returns `false` if the table is full or the address is invalid/already present.
+  bool addTarget(char const* address);
+  bool removeTarget(char const* address);
+  void clearTargets();
+
+  std::size_t targetCount() const;
+  PeripheralTarget const* target(std::size_t index) const;
+
+  // Maximum time to wait for the connection
+  void setConnectTimeout(std::uint32_t timeout);
+  // Maximum time spent connected to a single peripheral
+  void setDrainDeadline(std::uint32_t deadline);
+  // The peripheral is considered drained after this time without new data
+  void setDrainIdleTime(std::uint32_t idleTime);
+  // Amount of ms of waiting that is worth as much as a single byte of backlog
+  // when picking the next target. Lower value = more fairness, higher = more throughput.
+  void setAgingDivisor(std::uint32_t divisor);
+
+  // Visit the next peripheral: connect, drain the data and disconnect.
+  // Returns `false` if there are no targets or the connection failed.
+  bool pollNext();
+
+  // Visit every peripheral exactly once, in the order of their scores at the start of the round.
+  // Returns the amount of successful visits.
+  std::size_t pollAll();
+
+  PollerStats const& stats() const;
+  void resetStats();
+
+private:
+  int findTarget(char const* address) const;
+  std::uint32_t score(PeripheralTarget const& target, std::uint32_t now) const;
+  std::size_t selectNext(std::uint32_t now) const;
+  void startPolling();
+  bool visit(PeripheralTarget& target);
+  void drain(PeripheralTarget& target);
+
+  HM10& m_module;
+
+  PeripheralTarget m_targets[HM10_CENTRAL_MAX_TARGETS] { };
+  std::size_t m_targetCount { 0 };
+
+  std::uint32_t m_connectTimeout { 5000 };
+  std::uint32_t m_drainDeadline { 2000 };
+  std::uint32_t m_drainIdleTime { 100 };
+  std::uint32_t m_agingDivisor { 10 };
+
+  PollerStats m_stats { };
+  std::uint32_t m_firstPollTime { 0 };
+  bool m_pollStarted { false };
+};
+
+}
@@ -0,0 +1,159 @@
+/*
+ * hm10_config.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10.hpp"
+#include "hm10_config.hpp"
+#include "hm10_debug.hpp"
+#include <cstring>
+
+namespace HM10 {
+
+namespace {
+
+constexpr char ConfigurationMagic[] { 'H', 'M', 'C', 'F' };
+constexpr std::size_t PayloadSize { configurationPayloadSize() };
+
+static_assert(PayloadSize <= 0xFFFF, "Configuration payload length has to fit in u16");
+
+std::uint32_t crc32(std::uint8_t const* data, std::size_t length) {
+  // Bitwise - it's a hundred bytes, once in a while, so a lookup table is not worth its flash
+  std::uint32_t crc { 0xFFFFFFFFU };
+  for (std::size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ ((crc & 1U) != 0 ? 0xEDB88320U : 0U);
+    }
+  }
+  return ~crc;
+}
+
+void writeNumber(std::uint8_t* destination, std::uint32_t value, std::size_t size) {
+  for (std::size_t i = 0; i < size; i++) {
+    destination[i] = static_cast<std::uint8_t>(value >> (8 * i));
+  }
+}
+
+std::uint32_t readNumber(std::uint8_t const* source, std::size_t size) {
+  std::uint32_t value { 0 };
+  for (std::size_t i = 0; i < size; i++) {
+    value |= static_cast<std::uint32_t>(source[i]) << (8 * i);
+  }
+  return value;
+}
+
+// Returns the payload, or nullptr if the blob is broken or from a different version
+std::uint8_t const* validPayload(std::uint8_t const* blob, std::size_t length) {
+  if (blob == nullptr || length < ConfigurationBlobSize) {
+    return nullptr;
+  }
+  if (std::memcmp(blob, ConfigurationMagic, sizeof(ConfigurationMagic)) != 0 || blob[4] != ConfigurationVersion
+      || blob[5] != ConfigurationPropertyCount || readNumber(&blob[6], 2) != PayloadSize) {
+    return nullptr;
+  }
+  std::size_t const checkedLength = ConfigurationHeaderSize + PayloadSize;
+  if (readNumber(&blob[checkedLength], 4) != crc32(blob, checkedLength)) {
+    return nullptr;
+  }
+  return &blob[ConfigurationHeaderSize];
+}
+
+}
+
+std::size_t HM10::snapshot(std::uint8_t* blob, std::size_t size) {
+  if (blob == nullptr || size < ConfigurationBlobSize) {
+    return 0;
+  }
+
+  debugLog("Taking configuration snapshot");
+  if (!readConfiguration(&blob[ConfigurationHeaderSize])) {
+    return 0;
+  }
+
+  std::memcpy(blob, ConfigurationMagic, sizeof(ConfigurationMagic));
+  blob[4] = ConfigurationVersion;
+  blob[5] = static_cast<std::uint8_t>(ConfigurationPropertyCount);
+  writeNumber(&blob[6], PayloadSize, 2);
+  std::size_t const checkedLength = ConfigurationHeaderSize + PayloadSize;
+  writeNumber(&blob[checkedLength], crc32(blob, checkedLength), 4);
+  return ConfigurationBlobSize;
+}
+
+int HM10::restore(std::uint8_t const* blob, std::size_t length, bool rebootAfterChanges) {
+  std::uint8_t const* const wanted = validPayload(blob, length);
+  if (wanted == nullptr) {
+    debugLog("Invalid configuration blob");
+    return -1;
+  }
+
+  // Reading is cheaper than writing (no flash write in the module), and most of the settings usually match
+  std::uint8_t current[PayloadSize] { };
+  if (!readConfiguration(current)) {
+    return -1;
+  }
+
+  int changed { 0 };
+  std::size_t offset { 1 };
+  for (ConfigurationProperty const& property : ConfigurationProperties) {
+    std::uint8_t const* const value = &wanted[offset];
+    bool const differs = std::memcmp(value, &current[offset], property.size) != 0;
+    offset += property.size;
+    if (!differs) {
+      continue;
+    }
+
+    bool success { false };
+    if (property.base == 0) {
+      char text[16] { };
+      std::memcpy(text, value, property.size);
+      success = transmitAndCheckResponse(property.setResponse, property.setFormat, text);
+    } else {
+      success = transmitAndCheckResponse(property.setResponse, property.setFormat,
+                                         static_cast<int>(readNumber(value, property.size)));
+    }
+    if (!success) {
+      debugLog("Restoring %s failed", property.query);
+      return -1;
+    }
+    changed++;
+  }
+
+  // Baudrate goes last, changing it reboots the module (and that applies the rest of the settings too)
+  if (wanted[0] != current[0]) {
+    changed++;
+    return setBaudRate(static_cast<Baudrate>(wanted[0])) ? changed : -1;
+  }
+
+  if (changed > 0 && rebootAfterChanges && !reboot()) {
+    return -1;
+  }
+  return changed;
+}
+
+bool HM10::readConfiguration(std::uint8_t* payload) {
+  // Driver keeps the UART baudrate in sync with the module, so it's not queried
+  payload[0] = static_cast<std::uint8_t>(m_currentBaudrate);
+  std::size_t offset { 1 };
+  for (ConfigurationProperty const& property : ConfigurationProperties) {
+    if (!transmitAndCheckResponse(property.queryResponse, "%s", property.query)) {
+      debugLog("Reading %s failed", property.query);
+      return false;
+    }
+
+    if (property.base == 0) {
+      char text[16] { };
+      copyStringFromResponse(property.valueOffset, text, property.size + 1);
+      std::memcpy(&payload[offset], text, property.size);
+    } else {
+      long const value = extractNumberFromResponse(property.valueOffset, property.base);
+      writeNumber(&payload[offset], static_cast<std::uint32_t>(value), property.size);
+    }
+    offset += property.size;
+  }
+  return true;
+}
+
+}
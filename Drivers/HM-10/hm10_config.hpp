@@ -0,0 +1,96 @@
+/*
+ * hm10_config.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Module configuration dump and restore, see `HM10::snapshot` and `HM10::restore`.
+ * The blob can be stored in MCU flash and restored on a replacement module, to clone a known-good configuration
+ * without a scripted provisioning sequence:
+ *
+ *   std::uint8_t blob[HM10::ConfigurationBlobSize];
+ *   std::size_t const length = hm10.snapshot(blob, sizeof(blob));
+ *   ...
+ *   int const changed = hm10.restore(blob, length);
+ *
+ * Blob format (little endian):
+ *   header: "HMCF", u8 version, u8 amount of settings, u16 payload length
+ *   payload: UART baudrate (u8), then every setting from `ConfigurationProperties`, in table order -
+ *            numbers take `size` bytes, text is `size` characters padded with zeros
+ *   trailer: u32 CRC-32 (IEEE 802.3) of the header and the payload
+ *
+ * The module answers one command at a time, so the settings are read one by one - the whole snapshot takes
+ * about 30 command round trips. The table order is a part of the format, change the version if it changes.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace HM10 {
+
+struct ConfigurationProperty {
+  // Query command, and the expected response prefix
+  char const* query;
+  char const* queryResponse;
+  // Where the value starts in the response
+  std::size_t valueOffset;
+  // 10 or 16 for numbers, 0 for text
+  int base;
+  // Bytes in the blob
+  std::size_t size;
+  // Set command (with a single `int` or string argument), and the expected response prefix
+  char const* setFormat;
+  char const* setResponse;
+};
+
+constexpr ConfigurationProperty ConfigurationProperties[] = {
+  { "AT+ADDR?", "OK+ADDR", 8, 0, 12, "AT+ADDR%s", "OK+Set" },
+  { "AT+NAME?", "OK+NAME", 8, 0, 12, "AT+NAME%s", "OK+Set" },
+  { "AT+ADVI?", "OK+Get", 7, 16, 1, "AT+ADVI%X", "OK+Set" },
+  { "AT+ADTY?", "OK+Get", 7, 10, 1, "AT+ADTY%d", "OK+Set" },
+  { "AT+ALLO?", "OK+Get", 7, 10, 1, "AT+ALLO%d", "OK+Set" },
+  { "AT+AD1??", "OK+AD", 8, 0, 12, "AT+AD1%s", "OK+AD" },
+  { "AT+AD2??", "OK+AD", 8, 0, 12, "AT+AD2%s", "OK+AD" },
+  { "AT+AD3??", "OK+AD", 8, 0, 12, "AT+AD3%s", "OK+AD" },
+  { "AT+COMI?", "OK+Get", 7, 10, 1, "AT+COMI%d", "OK+Set" },
+  { "AT+COMA?", "OK+Get", 7, 10, 1, "AT+COMA%d", "OK+Set" },
+  { "AT+COLA?", "OK+Get", 7, 10, 1, "AT+COLA%d", "OK+Set" },
+  { "AT+COSU?", "OK+Get", 7, 10, 1, "AT+COSU%d", "OK+Set" },
+  { "AT+COUP?", "OK+Get", 7, 10, 1, "AT+COUP%d", "OK+Set" },
+  { "AT+CHAR?", "OK+Get", 9, 16, 2, "AT+CHAR0x%04X", "OK+Set" },
+  { "AT+UUID?", "OK+Get", 9, 16, 2, "AT+UUID0x%04X", "OK+Set" },
+  { "AT+NOTI?", "OK+Get", 7, 10, 1, "AT+NOTI%d", "OK+Set" },
+  { "AT+NOTP?", "OK+Get", 7, 10, 1, "AT+NOTP%d", "OK+Set" },
+  { "AT+FFE2?", "OK+Get", 7, 10, 1, "AT+FFE2%d", "OK+Set" },
+  { "AT+GAIN?", "OK+Get", 7, 10, 1, "AT+GAIN%d", "OK+Set" },
+  { "AT+IMME?", "OK+Get", 7, 10, 1, "AT+IMME%d", "OK+Set" },
+  { "AT+MODE?", "OK+Get", 7, 10, 1, "AT+MODE%d", "OK+Set" },
+  { "AT+PCTL?", "OK+Get", 7, 10, 1, "AT+PCTL%d", "OK+Set" },
+  { "AT+POWE?", "OK+Get", 7, 10, 1, "AT+POWE%d", "OK+Set" },
+  { "AT+PWRM?", "OK+Get", 7, 10, 1, "AT+PWRM%d", "OK+Set" },
+  { "AT+RELI?", "OK+Get", 7, 10, 1, "AT+RELI%d", "OK+Set" },
+  { "AT+ROLE?", "OK+Get", 7, 10, 1, "AT+ROLE%d", "OK+Set" },
+  { "AT+TYPE?", "OK+Get", 7, 10, 1, "AT+TYPE%d", "OK+Set" },
+  { "AT+PASS?", "OK+Get", 7, 10, 4, "AT+PASS%06d", "OK+Set" },
+  { "AT+UART?", "OK+Get", 7, 10, 1, "AT+UART%d", "OK+Set" }
+};
+
+constexpr std::size_t ConfigurationPropertyCount { sizeof(ConfigurationProperties)
+                                                   / sizeof(ConfigurationProperties[0]) };
+
+constexpr std::size_t configurationPayloadSize() {
+  std::size_t size { 1 }; // baudrate
+  for (ConfigurationProperty const& property : ConfigurationProperties) {
+    size += property.size;
+  }
+  return size;
+}
+
+constexpr std::uint8_t ConfigurationVersion { 1 };
+constexpr std::size_t ConfigurationHeaderSize { 8 };
+constexpr std::size_t ConfigurationBlobSize { ConfigurationHeaderSize + configurationPayloadSize() + 4 };
+
+}
@@ -126,4 +126,28 @@ enum class BondMode : std::uint8_t {
 struct Version {
   char version[16];
 };
+
+// Unknown until the first response or message from the module, see HM10::powerState
+enum class PowerState : std::uint8_t {
+  Unknown = 0, Awake = 1, Asleep = 2
+};
+
+// How the end of a received message is detected, see HM10::setFrameBoundary
+// IdleLine - every idle line interrupt (one character time of silence) ends the message
+// Timeout - silence of N timer ticks ends the message, idle line interrupt is disabled
+// Terminator - idle line ends the message only if it ends with the terminator ("\r\n" replies of the clones),
+//              silence of N timer ticks ends it anyway
+enum class FrameBoundary : std::uint8_t {
+  IdleLine = 0, Timeout = 1, Terminator = 2
+};
+
+// Where the data/connected/disconnected callbacks run, see HM10::setDataCallback
+// Interrupt - straight from the UART interrupt, lowest latency, but the callback can't block or call the RTOS API
+// Deferred - the interrupt copies the event and the callback runs later in the timer service task
+//            (xTimerPendFunctionCall(FromISR)). It's a task, so the RTOS API (with zero timeout) and printf over ITM
+//            are fine, but it must NOT block - no delays, no waiting on queues/semaphores, no HM10 commands -
+//            every software timer and pended function waits for it
+enum class CallbackDispatch : std::uint8_t {
+  Interrupt = 0, Deferred = 1
+};
 }
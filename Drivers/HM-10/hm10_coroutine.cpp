@@ -0,0 +1,420 @@
+/*
+ * hm10_coroutine.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_coroutine.hpp"
+
+#if defined(__cpp_impl_coroutine) && defined(USE_RTOS_DELAY)
+#include "hm10_format.hpp"
+#include "hm10_platform.hpp"
+#include <cstddef>
+#include <exception>
+
+namespace HM10 {
+
+namespace {
+
+struct FramePool {
+  alignas(std::max_align_t) std::uint8_t frames[HM10_COROUTINE_FRAME_COUNT][HM10_COROUTINE_FRAME_SIZE] { };
+  bool used[HM10_COROUTINE_FRAME_COUNT] { };
+};
+
+FramePool framePool { };
+
+bool passed(std::uint32_t now, std::uint32_t deadline) {
+  return static_cast<std::int32_t>(now - deadline) >= 0;
+}
+
+}
+
+// ===== Task ===== //
+
+void* Task::promise_type::operator new(std::size_t size) noexcept {
+  if (size > HM10_COROUTINE_FRAME_SIZE) {
+    return nullptr;
+  }
+
+  CriticalSection const criticalSection { };
+  for (std::size_t i = 0; i < HM10_COROUTINE_FRAME_COUNT; i++) {
+    if (!framePool.used[i]) {
+      framePool.used[i] = true;
+      return &framePool.frames[i][0];
+    }
+  }
+  return nullptr;
+}
+
+void Task::promise_type::operator delete(void* frame, std::size_t) noexcept {
+  CriticalSection const criticalSection { };
+  for (std::size_t i = 0; i < HM10_COROUTINE_FRAME_COUNT; i++) {
+    if (frame == &framePool.frames[i][0]) {
+      framePool.used[i] = false;
+      return;
+    }
+  }
+}
+
+void Task::promise_type::unhandled_exception() const noexcept {
+  std::terminate();
+}
+
+Task::Task(Task&& other) noexcept
+    : m_handle(other.m_handle) {
+  other.m_handle = nullptr;
+}
+
+Task& Task::operator=(Task&& other) noexcept {
+  if (this != &other) {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+    m_handle = other.m_handle;
+    other.m_handle = nullptr;
+  }
+  return *this;
+}
+
+Task::~Task() {
+  if (m_handle) {
+    m_handle.destroy();
+  }
+}
+
+bool Task::valid() const {
+  return static_cast<bool>(m_handle);
+}
+
+// ===== Executor ===== //
+
+bool Executor::spawn(Task task) {
+  if (!task.valid()) {
+    return false;
+  }
+
+  for (auto& slot : m_tasks) {
+    if (!slot) {
+      slot = task.m_handle;
+      task.m_handle = nullptr;
+      Waiter waiter { };
+      // Armed without timeout and woken immediately - it just puts the task into the ready queue
+      arm(waiter, slot, osWaitForever);
+      wake(waiter);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Executor::runOnce(std::uint32_t maxWait) {
+  m_thread = osThreadGetId();
+  if (activeTasks() == 0) {
+    return false;
+  }
+
+  std::uint32_t wait { 0 };
+  {
+    CriticalSection const criticalSection { };
+    if (m_readyHead == m_readyTail) {
+      std::uint32_t const timerWait = timeToNextTimer(platformTicks());
+      wait = timerWait < maxWait ? timerWait : maxWait;
+    }
+  }
+  if (wait > 0) {
+    osThreadFlagsWait(HM10_COROUTINE_THREAD_FLAG, osFlagsWaitAny, wait);
+  }
+
+  fireTimers(platformTicks());
+  std::coroutine_handle<> handle { };
+  while (popReady(handle)) {
+    handle.resume();
+  }
+
+  destroyFinishedTasks();
+  return activeTasks() > 0;
+}
+
+void Executor::run() {
+  while (runOnce()) {
+  }
+}
+
+std::size_t Executor::activeTasks() const {
+  std::size_t count { 0 };
+  for (auto const& task : m_tasks) {
+    count += task ? 1 : 0;
+  }
+  return count;
+}
+
+void Executor::arm(Waiter& waiter, std::coroutine_handle<> handle, std::uint32_t timeout) {
+  CriticalSection const criticalSection { };
+  waiter.handle = handle;
+  waiter.armed = true;
+  if (timeout == osWaitForever) {
+    return;
+  }
+
+  for (auto& timer : m_timers) {
+    if (timer.waiter == nullptr) {
+      timer.waiter = &waiter;
+      timer.deadline = platformTicks() + timeout;
+      return;
+    }
+  }
+}
+
+void Executor::wake(Waiter& waiter) {
+  {
+    CriticalSection const criticalSection { };
+    if (!waiter.armed) {
+      return;
+    }
+    waiter.armed = false;
+
+    for (auto& timer : m_timers) {
+      if (timer.waiter == &waiter) {
+        timer.waiter = nullptr;
+      }
+    }
+
+    m_ready[m_readyHead % HM10_COROUTINE_FRAME_COUNT] = waiter.handle;
+    m_readyHead++;
+  }
+
+  if (m_thread != nullptr) {
+    osThreadFlagsSet(m_thread, HM10_COROUTINE_THREAD_FLAG);
+  }
+}
+
+void Executor::fireTimers(std::uint32_t now) {
+  for (auto& timer : m_timers) {
+    Waiter* waiter { nullptr };
+    {
+      CriticalSection const criticalSection { };
+      if (timer.waiter != nullptr && passed(now, timer.deadline)) {
+        waiter = timer.waiter;
+      }
+    }
+    if (waiter != nullptr) {
+      wake(*waiter);
+    }
+  }
+}
+
+std::uint32_t Executor::timeToNextTimer(std::uint32_t now) const {
+  std::uint32_t wait { osWaitForever };
+  for (auto const& timer : m_timers) {
+    if (timer.waiter != nullptr) {
+      std::uint32_t const left = passed(now, timer.deadline) ? 0 : timer.deadline - now;
+      wait = left < wait ? left : wait;
+    }
+  }
+  return wait;
+}
+
+bool Executor::popReady(std::coroutine_handle<>& handle) {
+  CriticalSection const criticalSection { };
+  if (m_readyHead == m_readyTail) {
+    return false;
+  }
+  handle = m_ready[m_readyTail % HM10_COROUTINE_FRAME_COUNT];
+  m_readyTail++;
+  return true;
+}
+
+void Executor::destroyFinishedTasks() {
+  for (auto& task : m_tasks) {
+    if (task && task.done()) {
+      task.destroy();
+      task = nullptr;
+    }
+  }
+}
+
+// ===== AsyncHM10 ===== //
+
+AsyncHM10::Operation::Operation(AsyncHM10& owner, char const* expectedResponse, std::uint32_t timeout)
+    : m_owner(owner), m_expectedResponse(expectedResponse), m_timeout(timeout) {
+}
+
+AsyncHM10::Operation::Operation(AsyncHM10& owner, std::uint8_t const* data, std::size_t length,
+                                std::uint32_t timeout)
+    : m_owner(owner), m_data(data), m_length(length), m_timeout(timeout) {
+}
+
+void AsyncHM10::Operation::await_suspend(std::coroutine_handle<> handle) {
+  m_waiter.handle = handle;
+  if (m_owner.m_current != nullptr) {
+    // Module is busy, it'll be started when the previous operations are finished
+    if (m_owner.m_pendingTail != nullptr) {
+      m_owner.m_pendingTail->m_next = this;
+    } else {
+      m_owner.m_pendingHead = this;
+    }
+    m_owner.m_pendingTail = this;
+    return;
+  }
+  begin();
+}
+
+bool AsyncHM10::Operation::finish() {
+  HM10& module = m_owner.m_module;
+  {
+    CriticalSection const criticalSection { };
+    module.m_completionCallback = nullptr;
+    module.m_completionContext = nullptr;
+  }
+
+  bool success { !m_failed };
+  if (success && m_data == nullptr) {
+    if (module.isReceiving()) {
+      module.abortReceiving();
+      module.m_statistics.commandTimedOut(module.m_lastCommand);
+      success = false;
+    } else {
+      module.m_statistics.commandCompleted(module.m_lastCommand, platformTicks() - m_startTime);
+      success = module.compareWithResponse(m_expectedResponse);
+      module.m_statistics.responseChecked(module.m_lastCommand, success);
+    }
+  } else if (success) {
+    success = !module.isTransmitting();
+  }
+
+  // Hand the module over to the next operation
+  m_owner.m_current = nullptr;
+  Operation* const next = m_owner.m_pendingHead;
+  if (next != nullptr) {
+    m_owner.m_pendingHead = next->m_next;
+    if (m_owner.m_pendingHead == nullptr) {
+      m_owner.m_pendingTail = nullptr;
+    }
+    next->begin();
+  }
+  return success;
+}
+
+void AsyncHM10::Operation::format(char const* format, ...) {
+  std::va_list args;
+  va_start(args, format);
+  formatString(m_command, sizeof(m_command), format, args);
+  va_end(args);
+}
+
+void AsyncHM10::Operation::begin() {
+  HM10& module = m_owner.m_module;
+  Executor& executor = m_owner.m_executor;
+  m_owner.m_current = this;
+  executor.arm(m_waiter, m_waiter.handle, m_timeout);
+  {
+    CriticalSection const criticalSection { };
+    module.m_completionCallback = completed;
+    module.m_completionContext = this;
+  }
+
+  m_startTime = platformTicks();
+  if (m_data != nullptr) {
+    m_failed = !module.isConnected() || module.startDataTransmission(m_data, m_length) != HAL_OK;
+  } else {
+    module.copyCommandToBuffer("%s", m_command);
+    module.m_lastCommand = commandIndex(module.m_txBuffer);
+    if (!module.capabilities().supports(module.m_lastCommand)) {
+      module.m_statistics.commandRejected(module.m_lastCommand);
+      m_failed = true;
+    } else {
+      module.startReceivingToBuffer();
+      m_failed = module.startTransmission(reinterpret_cast<std::uint8_t const*>(&module.m_txBuffer[0]),
+                                          module.m_txDataLength) != HAL_OK;
+      if (m_failed) {
+        module.abortReceiving();
+      }
+    }
+  }
+
+  if (m_failed) {
+    executor.wake(m_waiter);
+  }
+}
+
+void AsyncHM10::Operation::completed(void* context) {
+  // Called from interrupts - only the completion this operation waits for wakes it up
+  Operation* const operation = static_cast<Operation*>(context);
+  HM10 const& module = operation->m_owner.m_module;
+  bool const done = (operation->m_data == nullptr) ? !module.isReceiving() : !module.isTransmitting();
+  if (done) {
+    operation->m_owner.m_executor.wake(operation->m_waiter);
+  }
+}
+
+AsyncHM10::AsyncHM10(HM10& module, Executor& executor)
+    : m_module(module), m_executor(executor) {
+}
+
+Executor& AsyncHM10::executor() const {
+  return m_executor;
+}
+
+AsyncHM10::Awaiter<bool> AsyncHM10::isAlive() {
+  Awaiter<bool> awaiter { *this, [](HM10&, bool success) {
+    return success;
+  }, "OK", 100 };
+  awaiter.format("AT");
+  return awaiter;
+}
+
+AsyncHM10::Awaiter<Role> AsyncHM10::role() {
+  Awaiter<Role> awaiter { *this, [](HM10& module, bool success) {
+    return success ? static_cast<Role>(module.extractNumberFromResponse()) : Role::Invalid;
+  }, "OK+Get", 1000 };
+  awaiter.format("AT+ROLE?");
+  return awaiter;
+}
+
+AsyncHM10::Awaiter<bool> AsyncHM10::setRole(Role role) {
+  Awaiter<bool> awaiter { *this, [](HM10&, bool success) {
+    return success;
+  }, "OK+Set", 1000 };
+  awaiter.format("AT+ROLE%d", static_cast<std::uint8_t>(role));
+  return awaiter;
+}
+
+AsyncHM10::Awaiter<DeviceName> AsyncHM10::name() {
+  Awaiter<DeviceName> awaiter { *this, [](HM10& module, bool success) {
+    DeviceName name { };
+    if (success) {
+      module.copyStringFromResponse(8, name.name);
+    }
+    return name;
+  }, "OK+NAME", 1000 };
+  awaiter.format("AT+NAME?");
+  return awaiter;
+}
+
+AsyncHM10::Awaiter<bool> AsyncHM10::setName(char const* name) {
+  Awaiter<bool> awaiter { *this, [](HM10&, bool success) {
+    return success;
+  }, "OK+Set", 1000 };
+  awaiter.format("AT+NAME%s", name);
+  return awaiter;
+}
+
+AsyncHM10::Awaiter<bool> AsyncHM10::command(char const* command, char const* expectedResponse,
+                                             std::uint32_t timeout) {
+  Awaiter<bool> awaiter { *this, [](HM10&, bool success) {
+    return success;
+  }, expectedResponse, timeout };
+  awaiter.format("%s", command);
+  return awaiter;
+}
+
+AsyncHM10::Awaiter<bool> AsyncHM10::sendAsync(std::uint8_t const* data, std::size_t length, std::uint32_t timeout) {
+  return Awaiter<bool> { *this, [](HM10&, bool success) {
+    return success;
+  }, data, length, timeout };
+}
+
+}
+
+#endif
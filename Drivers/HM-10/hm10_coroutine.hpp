@@ -0,0 +1,298 @@
+/*
+ * hm10_coroutine.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * C++20 coroutine interface, available when the compiler supports coroutines (-std=c++20) and RTOS is used.
+ * Instead of one RTOS task (with its own ~2kB stack) per blocking flow, many flows can run as coroutines
+ * on a single task, each one written linearly:
+ *
+ *   HM10::Task provision(HM10::AsyncHM10& module) {
+ *     if (co_await module.role() != HM10::Role::Peripheral) {
+ *       co_await module.setRole(HM10::Role::Peripheral);
+ *     }
+ *     co_await module.setName("hm10");
+ *     co_await module.executor().sleep(100);
+ *   }
+ *
+ *   HM10::Executor executor;
+ *   HM10::AsyncHM10 module(hm10, executor);
+ *   executor.spawn(provision(module));
+ *   executor.run(); // in the task that owns the module
+ *
+ * Frames are allocated from a fixed pool (HM10_COROUTINE_FRAME_COUNT frames of HM10_COROUTINE_FRAME_SIZE bytes),
+ * never from the heap. If the pool is exhausted, the Task is invalid and `spawn` returns `false`.
+ * Operations on a single module are executed one by one, in the order they were awaited. Completion comes from
+ * the UART interrupts (receiveCompleted/transmitCompleted) - they only queue the coroutine and notify
+ * the executor task with a thread flag, the coroutine itself is always resumed in the executor task.
+ * Don't mix the coroutine and blocking API on the same module.
+ */
+
+#pragma once
+#include "hm10.hpp"
+
+#if defined(__cpp_impl_coroutine) && defined(USE_RTOS_DELAY)
+#include <coroutine>
+
+// Size of a single coroutine frame, in bytes
+#ifndef HM10_COROUTINE_FRAME_SIZE
+#define HM10_COROUTINE_FRAME_SIZE 512
+#endif
+
+// Amount of coroutine frames (including the nested ones)
+#ifndef HM10_COROUTINE_FRAME_COUNT
+#define HM10_COROUTINE_FRAME_COUNT 8
+#endif
+
+// Thread flag used to wake up the executor task, must not be used by that task for anything else
+#ifndef HM10_COROUTINE_THREAD_FLAG
+#define HM10_COROUTINE_THREAD_FLAG 0x00020000U
+#endif
+
+namespace HM10 {
+
+// Coroutine returning nothing. Can be spawned in the executor, or awaited by another coroutine.
+class Task {
+public:
+  struct promise_type {
+    struct FinalAwaiter {
+      bool await_ready() const noexcept {
+        return false;
+      }
+
+      // Nested task resumes its caller, top-level task stays suspended until the executor destroys it
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+        std::coroutine_handle<> const continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+      }
+
+      void await_resume() const noexcept {
+      }
+    };
+
+    static void* operator new(std::size_t size) noexcept;
+    static void operator delete(void* frame, std::size_t size) noexcept;
+
+    static Task get_return_object_on_allocation_failure() noexcept {
+      return Task { };
+    }
+
+    Task get_return_object() noexcept {
+      return Task { std::coroutine_handle<promise_type>::from_promise(*this) };
+    }
+
+    std::suspend_always initial_suspend() const noexcept {
+      return { };
+    }
+
+    FinalAwaiter final_suspend() const noexcept {
+      return { };
+    }
+
+    void return_void() const noexcept {
+    }
+
+    void unhandled_exception() const noexcept;
+
+    std::coroutine_handle<> continuation { };
+  };
+
+  Task() = default;
+  Task(Task&& other) noexcept;
+  Task& operator=(Task&& other) noexcept;
+  ~Task();
+
+  Task(Task const&) = delete;
+  Task& operator=(Task const&) = delete;
+
+  // `false` if the frame couldn't be allocated
+  bool valid() const;
+
+  // Awaiting a task starts it, and resumes the caller when it's done
+  bool await_ready() const noexcept {
+    return !m_handle || m_handle.done();
+  }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+    m_handle.promise().continuation = caller;
+    return m_handle;
+  }
+
+  void await_resume() const noexcept {
+  }
+
+private:
+  friend class Executor;
+
+  explicit Task(std::coroutine_handle<promise_type> handle)
+      : m_handle(handle) {
+  }
+
+  std::coroutine_handle<promise_type> m_handle { };
+};
+
+class Executor;
+
+// Single wake up of a suspended coroutine - only the first `Executor::wake` resumes it
+struct Waiter {
+  std::coroutine_handle<> handle { };
+  bool armed { false };
+};
+
+class Executor {
+public:
+  class SleepAwaiter {
+  public:
+    SleepAwaiter(Executor& executor, std::uint32_t time)
+        : m_executor(executor), m_time(time) {
+    }
+
+    bool await_ready() const noexcept {
+      return m_time == 0;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      m_executor.arm(m_waiter, handle, m_time);
+    }
+
+    void await_resume() const noexcept {
+    }
+
+  private:
+    Executor& m_executor;
+    std::uint32_t m_time;
+    Waiter m_waiter { };
+  };
+
+  // Starts the task on the next `runOnce`. Returns `false` if the task is invalid or there are too many tasks.
+  bool spawn(Task task);
+
+  // Resumes the ready coroutines, waiting up to `maxWait` ms for any of them (or a timer) to be ready.
+  // Returns `true` if there are still unfinished tasks.
+  bool runOnce(std::uint32_t maxWait = osWaitForever);
+  // Runs until all the tasks are finished
+  void run();
+
+  std::size_t activeTasks() const;
+
+  // Suspends the coroutine for `time` ms, without blocking the executor task
+  SleepAwaiter sleep(std::uint32_t time) {
+    return SleepAwaiter { *this, time };
+  }
+
+  // For the awaiters: suspends `handle` until `wake(waiter)` or `timeout` ms (osWaitForever - no timeout)
+  void arm(Waiter& waiter, std::coroutine_handle<> handle, std::uint32_t timeout);
+  // Safe to call from interrupts
+  void wake(Waiter& waiter);
+
+private:
+  struct Timer {
+    Waiter* waiter { nullptr };
+    std::uint32_t deadline { 0 };
+  };
+
+  void fireTimers(std::uint32_t now);
+  std::uint32_t timeToNextTimer(std::uint32_t now) const;
+  bool popReady(std::coroutine_handle<>& handle);
+  void destroyFinishedTasks();
+
+  // Every coroutine has its own frame and can wait for one thing at a time, so the frame count is enough
+  std::coroutine_handle<> m_ready[HM10_COROUTINE_FRAME_COUNT] { };
+  std::size_t m_readyHead { 0 };
+  std::size_t m_readyTail { 0 };
+  Timer m_timers[HM10_COROUTINE_FRAME_COUNT] { };
+  std::coroutine_handle<Task::promise_type> m_tasks[HM10_COROUTINE_FRAME_COUNT] { };
+  osThreadId_t m_thread { nullptr };
+};
+
+class AsyncHM10 {
+public:
+  class Operation {
+  public:
+    bool await_ready() const noexcept {
+      return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle);
+
+  protected:
+    Operation(AsyncHM10& owner, char const* expectedResponse, std::uint32_t timeout);
+    Operation(AsyncHM10& owner, std::uint8_t const* data, std::size_t length, std::uint32_t timeout);
+
+    // Finishes the operation and starts the next queued one, returns `true` on success
+    bool finish();
+
+    AsyncHM10& m_owner;
+    char m_command[32] { };
+
+  private:
+    friend class AsyncHM10;
+
+    void format(char const* format, ...);
+    void begin();
+    static void completed(void* context);
+
+    char const* m_expectedResponse { nullptr };
+    std::uint8_t const* m_data { nullptr };
+    std::size_t m_length { 0 };
+    std::uint32_t m_timeout;
+    std::uint32_t m_startTime { 0 };
+    bool m_failed { false };
+    Waiter m_waiter { };
+    Operation* m_next { nullptr };
+  };
+
+  // Awaiting it returns the parsed result (`ParseT` is called with the module, and the operation result)
+  template <typename T>
+  class Awaiter : public Operation {
+  public:
+    using ParseT = T(*)(HM10&, bool);
+
+    Awaiter(AsyncHM10& owner, ParseT parse, char const* expectedResponse, std::uint32_t timeout)
+        : Operation(owner, expectedResponse, timeout), m_parse(parse) {
+    }
+
+    Awaiter(AsyncHM10& owner, ParseT parse, std::uint8_t const* data, std::size_t length, std::uint32_t timeout)
+        : Operation(owner, data, length, timeout), m_parse(parse) {
+    }
+
+    T await_resume() {
+      bool const success = finish();
+      return m_parse(m_owner.m_module, success);
+    }
+
+  private:
+    friend class AsyncHM10;
+
+    ParseT m_parse;
+  };
+
+  AsyncHM10(HM10& module, Executor& executor);
+
+  Executor& executor() const;
+
+  Awaiter<bool> isAlive();
+  Awaiter<Role> role();
+  Awaiter<bool> setRole(Role role);
+  Awaiter<DeviceName> name();
+  Awaiter<bool> setName(char const* name);
+  // Sends any command (for example "AT+ADVI?"), returns `true` if the response starts with `expectedResponse`
+  Awaiter<bool> command(char const* command, char const* expectedResponse, std::uint32_t timeout = 1000);
+  // Sends the data to the connected device, `data` must stay valid until it's done
+  Awaiter<bool> sendAsync(std::uint8_t const* data, std::size_t length, std::uint32_t timeout = 1000);
+
+private:
+  HM10& m_module;
+  Executor& m_executor;
+  // Operation that currently owns the module, and the queue of the ones waiting for it
+  Operation* m_current { nullptr };
+  Operation* m_pendingHead { nullptr };
+  Operation* m_pendingTail { nullptr };
+};
+
+}
+
+#endif
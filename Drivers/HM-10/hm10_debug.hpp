@@ -10,15 +10,33 @@
 //#define HM10_DEBUG
 //#define HM10_DEBUG_LOWLEVEL
 
+// By default the logs go to the binary trace buffer (see hm10_trace.hpp), which is cheap enough to be
+// used in interrupts. Define HM10_DEBUG_PRINTF to print them immediately with printf instead.
+//#define HM10_DEBUG_PRINTF
+
+#if (defined(HM10_DEBUG) || defined(HM10_DEBUG_LOWLEVEL)) && !defined(HM10_DEBUG_PRINTF)
+#define HM10_TRACE_ENABLED
+#include "hm10_trace.hpp"
+#endif
+
 #ifdef HM10_DEBUG
+#ifdef HM10_DEBUG_PRINTF
 #include <cstdio>
 #define debugLog(format, ...) std::printf("[HM-10] <%s:%d>: " format "\n", __func__, __LINE__, ## __VA_ARGS__)
 #else
+#define debugLog(format, ...) HM10_TRACE("[HM-10] <" __FILE__ ":" HM10_TRACE_LINE ">: " format, ## __VA_ARGS__)
+#endif
+#else
 #define debugLog(...)
 #endif
 
 #ifdef HM10_DEBUG_LOWLEVEL
+#ifdef HM10_DEBUG_PRINTF
+#include <cstdio>
 #define debugLogLL(format, ...) std::printf("[HM-10][LL] <%s:%d>: " format "\n", __func__, __LINE__, ## __VA_ARGS__)
 #else
+#define debugLogLL(format, ...) HM10_TRACE("[HM-10][LL] <" __FILE__ ":" HM10_TRACE_LINE ">: " format, ## __VA_ARGS__)
+#endif
+#else
 #define debugLogLL(...)
 #endif
@@ -0,0 +1,119 @@
+/*
+ * hm10_events.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_events.hpp"
+
+#ifdef USE_RTOS_DELAY
+#include "hm10_platform.hpp"
+
+namespace HM10 {
+
+bool EventBus::initialize() {
+  if (m_flags != nullptr) {
+    return true;
+  }
+
+  osEventFlagsAttr_t attributes { };
+  attributes.name = "hm10Events";
+  attributes.cb_mem = &m_flagsControlBlock;
+  attributes.cb_size = sizeof(m_flagsControlBlock);
+  m_flags = osEventFlagsNew(&attributes);
+  return m_flags != nullptr;
+}
+
+bool EventBus::subscribeData(DataListenerT listener, void* context) {
+  return m_dataListeners.add(listener, context);
+}
+
+bool EventBus::subscribeConnected(ConnectedListenerT listener, void* context) {
+  return m_connectedListeners.add(listener, context);
+}
+
+bool EventBus::subscribeDisconnected(DisconnectedListenerT listener, void* context) {
+  return m_disconnectedListeners.add(listener, context);
+}
+
+void EventBus::unsubscribe(void* context) {
+  m_dataListeners.remove(context);
+  m_connectedListeners.remove(context);
+  m_disconnectedListeners.remove(context);
+}
+
+std::uint32_t EventBus::wait(std::uint32_t events, std::uint32_t timeout, bool clear) {
+  if (m_flags == nullptr) {
+    return 0;
+  }
+
+  std::uint32_t const result = osEventFlagsWait(m_flags, events, osFlagsWaitAny | (clear ? 0 : osFlagsNoClear),
+                                                timeout);
+  // Errors have the highest bit set
+  return (result & osFlagsError) != 0 ? 0 : (result & events);
+}
+
+void EventBus::clear(std::uint32_t events) {
+  if (m_flags != nullptr) {
+    osEventFlagsClear(m_flags, events);
+  }
+}
+
+void EventBus::publishData(char const* data, std::size_t length) {
+  for (std::size_t i = 0; i < m_dataListeners.count; i++) {
+    m_dataListeners.listeners[i].function(m_dataListeners.listeners[i].context, data, length);
+  }
+  setFlags(DataReceived);
+}
+
+void EventBus::publishConnected(MACAddress const& mac) {
+  for (std::size_t i = 0; i < m_connectedListeners.count; i++) {
+    m_connectedListeners.listeners[i].function(m_connectedListeners.listeners[i].context, mac);
+  }
+  setFlags(Connected);
+}
+
+void EventBus::publishDisconnected() {
+  for (std::size_t i = 0; i < m_disconnectedListeners.count; i++) {
+    m_disconnectedListeners.listeners[i].function(m_disconnectedListeners.listeners[i].context);
+  }
+  setFlags(Disconnected);
+}
+
+void EventBus::setFlags(std::uint32_t events) {
+  if (m_flags != nullptr) {
+    osEventFlagsSet(m_flags, events);
+  }
+}
+
+template <typename ListenerT>
+bool EventBus::ListenerList<ListenerT>::add(ListenerT function, void* context) {
+  if (function == nullptr) {
+    return false;
+  }
+
+  CriticalSection const criticalSection { };
+  if (count >= HM10_EVENT_MAX_LISTENERS) {
+    return false;
+  }
+  listeners[count] = Listener<ListenerT> { function, context };
+  count++;
+  return true;
+}
+
+template <typename ListenerT>
+void EventBus::ListenerList<ListenerT>::remove(void* context) {
+  CriticalSection const criticalSection { };
+  std::size_t kept { 0 };
+  for (std::size_t i = 0; i < count; i++) {
+    if (listeners[i].context != context) {
+      listeners[kept++] = listeners[i];
+    }
+  }
+  count = kept;
+}
+
+}
+
+#endif
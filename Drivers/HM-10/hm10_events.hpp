@@ -0,0 +1,105 @@
+/*
+ * hm10_events.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Multi-subscriber event bus for the connection and data events.
+ * Every event type has its own fixed-size list of listeners (function + context), and every event also sets
+ * a flag in an event group (FreeRTOS event group, through CMSIS-RTOS2 event flags), so the tasks can block
+ * on them with `wait()`.
+ *
+ *   HM10::EventBus events;
+ *   events.initialize();
+ *   events.subscribeConnected(ledOn, &led);
+ *   events.subscribeDisconnected(ledOff, &led);
+ *   hm10.setEventBus(&events);
+ *
+ * Listeners are called from the UART interrupt, like the HM10 callbacks - keep them short. Data listeners get
+ * the pointer to the driver's message buffer (no copy), valid only during the call.
+ * The interrupt path reads the listener lists without locking, (un)subscribing masks the interrupts
+ * for a moment, so it's safe to do it from any task at any time. Setting the flags from interrupt is deferred
+ * to the RTOS timer task by FreeRTOS, so it doesn't wake any task directly from the interrupt.
+ */
+
+#pragma once
+#include "hm10.hpp"
+
+#ifdef USE_RTOS_DELAY
+#include <FreeRTOS.h>
+
+// Maximum amount of listeners of every event type
+#ifndef HM10_EVENT_MAX_LISTENERS
+#define HM10_EVENT_MAX_LISTENERS 4
+#endif
+
+namespace HM10 {
+
+class EventBus {
+public:
+  // Event flags
+  static constexpr std::uint32_t Connected { 1U << 0 };
+  static constexpr std::uint32_t Disconnected { 1U << 1 };
+  static constexpr std::uint32_t DataReceived { 1U << 2 };
+  static constexpr std::uint32_t AllEvents { Connected | Disconnected | DataReceived };
+
+  using DataListenerT = void(*)(void*, char const*, std::size_t);
+  using ConnectedListenerT = void(*)(void*, MACAddress const&);
+  using DisconnectedListenerT = void(*)(void*);
+
+  EventBus() = default;
+  EventBus(EventBus const&) = delete;
+  EventBus& operator=(EventBus const&) = delete;
+
+  // Creates the event group, call it before using the bus (and after the RTOS kernel is initialized)
+  bool initialize();
+
+  // Return `false` if the list is full
+  bool subscribeData(DataListenerT listener, void* context);
+  bool subscribeConnected(ConnectedListenerT listener, void* context);
+  bool subscribeDisconnected(DisconnectedListenerT listener, void* context);
+  // Remove every subscription of `context` (from all the lists)
+  void unsubscribe(void* context);
+
+  // Waits until any of `events` is set, returns the events that were set (0 on timeout).
+  // With `clear`, the returned events are cleared - use `false` when more than one task waits for the same event.
+  std::uint32_t wait(std::uint32_t events, std::uint32_t timeout = osWaitForever, bool clear = true);
+  void clear(std::uint32_t events);
+
+  // Called by the driver, from interrupts
+  void publishData(char const* data, std::size_t length);
+  void publishConnected(MACAddress const& mac);
+  void publishDisconnected();
+
+private:
+  template <typename ListenerT>
+  struct Listener {
+    ListenerT function { nullptr };
+    void* context { nullptr };
+  };
+
+  template <typename ListenerT>
+  struct ListenerList {
+    Listener<ListenerT> listeners[HM10_EVENT_MAX_LISTENERS] { };
+    // Listeners are kept packed at the beginning, the interrupt iterates up to `count`
+    std::size_t count { 0 };
+
+    bool add(ListenerT function, void* context);
+    void remove(void* context);
+  };
+
+  void setFlags(std::uint32_t events);
+
+  ListenerList<DataListenerT> m_dataListeners { };
+  ListenerList<ConnectedListenerT> m_connectedListeners { };
+  ListenerList<DisconnectedListenerT> m_disconnectedListeners { };
+
+  osEventFlagsId_t m_flags { nullptr };
+  StaticEventGroup_t m_flagsControlBlock { };
+};
+
+}
+
+#endif
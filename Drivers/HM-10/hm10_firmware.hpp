@@ -0,0 +1,118 @@
+/*
+ * hm10_firmware.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Firmware variants and the commands they support.
+ * Detection is opt-in: `HM10::initialize(true)` or `HM10::detectFirmware()` probes the module (AT+VERR?, then
+ * AT+VERSION for the clones) and selects one of the tables below. Until then, the firmware is unknown. Commands that are not in the table fail right away, without transmitting anything,
+ * instead of waiting for a response that never comes - see `CommandStatistics::unsupported`.
+ *
+ * Tables are built from the command names in `CommandNames` at compile time. They are conservative for
+ * the clones: a command the clone answers in a different format fails on the response check anyway,
+ * so only the commands that can work with this driver are listed.
+ * Unknown firmware allows every command, like the driver does without the detection.
+ */
+
+#pragma once
+#include "hm10_statistics.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace HM10 {
+
+enum class Firmware : std::uint8_t {
+  Unknown = 0,
+  // Original JNHuaMao firmware, "HMSoft V6xx" (and older), "HMSoft V7xx"
+  HMSoftV6 = 1,
+  HMSoftV7 = 2,
+  // Clones: CC41-A (Bolutek firmware) and MLT-BT05
+  CC41A = 3,
+  MLTBT05 = 4
+};
+
+struct FirmwareCapabilities {
+  Firmware firmware;
+  char const* name;
+  // Bit N set - command N from `CommandNames` is supported
+  std::uint64_t commands;
+
+  constexpr bool supports(std::size_t command) const {
+    // Raw commands (not in `CommandNames`) are always passed through
+    return command >= KnownCommandCount || (commands & (std::uint64_t { 1 } << command)) != 0;
+  }
+};
+
+static_assert(KnownCommandCount <= 64, "Command mask is too small for CommandNames");
+
+namespace Detail {
+
+constexpr bool sameName(char const* a, char const* b) {
+  while (*a != '\0' && *a == *b) {
+    a++;
+    b++;
+  }
+  return *a == *b;
+}
+
+template <std::size_t N>
+constexpr std::uint64_t commandMask(char const* const (&names)[N]) {
+  std::uint64_t mask { 0 };
+  for (std::size_t i = 0; i < N; i++) {
+    for (std::size_t command = 0; command < KnownCommandCount; command++) {
+      if (sameName(names[i], CommandNames[command])) {
+        mask |= std::uint64_t { 1 } << command;
+      }
+    }
+  }
+  return mask;
+}
+
+// Catches typos in the tables - every name must be in `CommandNames`
+template <std::size_t N>
+constexpr bool knownCommands(char const* const (&names)[N]) {
+  for (std::size_t i = 0; i < N; i++) {
+    bool found { false };
+    for (std::size_t command = 0; command < KnownCommandCount; command++) {
+      found = found || sameName(names[i], CommandNames[command]);
+    }
+    if (!found) {
+      return false;
+    }
+  }
+  return true;
+}
+
+constexpr std::uint64_t AllCommands { KnownCommandCount == 64 ? ~std::uint64_t { 0 }
+                                                              : (std::uint64_t { 1 } << KnownCommandCount) - 1 };
+
+// Added in V7xx: advertisement data slots (AT+AD1-3), UART sleep type and the second characteristic switch
+constexpr char const* V7OnlyCommands[] = { "AD", "UART", "FFE2" };
+
+constexpr char const* CC41ACommands[] = { "AT", "BAUD", "NAME", "POWE", "RESET", "ROLE", "TYPE" };
+
+constexpr char const* MLTBT05Commands[] = { "AT", "ADVI", "BAUD", "CHAR", "NAME", "POWE", "RESET", "ROLE", "SLEEP",
+                                            "TYPE", "UUID" };
+
+}
+
+constexpr FirmwareCapabilities FirmwareTable[] = {
+  { Firmware::Unknown, "unknown", Detail::AllCommands },
+  { Firmware::HMSoftV6, "HMSoft V6xx", Detail::AllCommands & ~Detail::commandMask(Detail::V7OnlyCommands) },
+  { Firmware::HMSoftV7, "HMSoft V7xx", Detail::AllCommands },
+  { Firmware::CC41A, "CC41-A", Detail::commandMask(Detail::CC41ACommands) },
+  { Firmware::MLTBT05, "MLT-BT05", Detail::commandMask(Detail::MLTBT05Commands) }
+};
+
+constexpr FirmwareCapabilities const& firmwareCapabilities(Firmware firmware) {
+  return FirmwareTable[static_cast<std::size_t>(firmware) < sizeof(FirmwareTable) / sizeof(FirmwareTable[0])
+                       ? static_cast<std::size_t>(firmware) : 0];
+}
+
+static_assert(Detail::knownCommands(Detail::V7OnlyCommands) && Detail::knownCommands(Detail::CC41ACommands)
+              && Detail::knownCommands(Detail::MLTBT05Commands), "Unknown command name in a firmware table");
+
+}
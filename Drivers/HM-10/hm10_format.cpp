@@ -0,0 +1,333 @@
+/*
+ * hm10_format.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_format.hpp"
+#include <cstdint>
+
+namespace HM10 {
+
+namespace {
+
+// Writes what fits in the buffer, but counts everything
+class Output {
+public:
+  Output(char* buffer, std::size_t size)
+      : m_buffer(buffer), m_size(size) {
+  }
+
+  void put(char character) {
+    if (m_length + 1 < m_size) {
+      m_buffer[m_length] = character;
+    }
+    m_length++;
+  }
+
+  void repeat(char character, int count) {
+    for (int i = 0; i < count; i++) {
+      put(character);
+    }
+  }
+
+  void terminate() {
+    if (m_size > 0) {
+      m_buffer[m_length < m_size ? m_length : m_size - 1] = '\0';
+    }
+  }
+
+  std::size_t length() const {
+    return m_length;
+  }
+
+private:
+  char* m_buffer;
+  std::size_t m_size;
+  std::size_t m_length { 0 };
+};
+
+struct Spec {
+  bool leftAlign { false };
+  bool zeroPad { false };
+  bool plus { false };
+  bool space { false };
+  int width { 0 };
+  int precision { -1 };
+};
+
+void formatText(Output& output, Spec const& spec, char const* text) {
+  if (text == nullptr) {
+    text = "(null)";
+  }
+  int length { 0 };
+  while (text[length] != '\0' && (spec.precision < 0 || length < spec.precision)) {
+    length++;
+  }
+
+  int const padding = spec.width > length ? spec.width - length : 0;
+  if (!spec.leftAlign) {
+    output.repeat(' ', padding);
+  }
+  for (int i = 0; i < length; i++) {
+    output.put(text[i]);
+  }
+  if (spec.leftAlign) {
+    output.repeat(' ', padding);
+  }
+}
+
+void formatNumber(Output& output, Spec const& spec, std::uintmax_t value, bool negative, unsigned base,
+                  bool uppercase, char const* prefix) {
+  char digits[24] { };
+  int length { 0 };
+  char const* const symbols = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+  do {
+    digits[length++] = symbols[value % base];
+    value /= base;
+  } while (value != 0);
+
+  // Precision 0 with value 0 prints no digits
+  if (spec.precision == 0 && length == 1 && digits[0] == '0') {
+    length = 0;
+  }
+
+  char const sign = negative ? '-' : (spec.plus ? '+' : (spec.space ? ' ' : '\0'));
+  int prefixLength { 0 };
+  while (prefix[prefixLength] != '\0') {
+    prefixLength++;
+  }
+
+  int const zeros = spec.precision > length ? spec.precision - length : 0;
+  int const total = length + zeros + prefixLength + (sign != '\0' ? 1 : 0);
+  int padding = spec.width > total ? spec.width - total : 0;
+
+  // Zero padding is ignored with precision or left alignment, like in printf
+  bool const padWithZeros = spec.zeroPad && !spec.leftAlign && spec.precision < 0;
+  if (!spec.leftAlign && !padWithZeros) {
+    output.repeat(' ', padding);
+    padding = 0;
+  }
+  if (sign != '\0') {
+    output.put(sign);
+  }
+  for (int i = 0; i < prefixLength; i++) {
+    output.put(prefix[i]);
+  }
+  if (padWithZeros) {
+    output.repeat('0', padding);
+    padding = 0;
+  }
+  output.repeat('0', zeros);
+  while (length > 0) {
+    output.put(digits[--length]);
+  }
+  output.repeat(' ', padding);
+}
+
+enum class Length {
+  Default,
+  Char,
+  Short,
+  Long,
+  LongLong,
+  Size,
+  Max,
+  PtrDiff
+};
+
+}
+
+int formatString(char* buffer, std::size_t size, char const* format, std::va_list args) {
+  Output output { buffer, size };
+
+  for (char const* c = format; *c != '\0'; c++) {
+    if (*c != '%') {
+      output.put(*c);
+      continue;
+    }
+    c++;
+
+    Spec spec { };
+    for (;; c++) {
+      if (*c == '-') {
+        spec.leftAlign = true;
+      } else if (*c == '0') {
+        spec.zeroPad = true;
+      } else if (*c == '+') {
+        spec.plus = true;
+      } else if (*c == ' ') {
+        spec.space = true;
+      } else if (*c != '#') {
+        break;
+      }
+    }
+
+    if (*c == '*') {
+      spec.width = va_arg(args, int);
+      if (spec.width < 0) {
+        spec.leftAlign = true;
+        spec.width = -spec.width;
+      }
+      c++;
+    } else {
+      while (*c >= '0' && *c <= '9') {
+        spec.width = spec.width * 10 + (*c++ - '0');
+      }
+    }
+
+    if (*c == '.') {
+      c++;
+      spec.precision = 0;
+      if (*c == '*') {
+        spec.precision = va_arg(args, int);
+        c++;
+      } else {
+        while (*c >= '0' && *c <= '9') {
+          spec.precision = spec.precision * 10 + (*c++ - '0');
+        }
+      }
+    }
+
+    Length length { Length::Default };
+    if (*c == 'h') {
+      length = (c[1] == 'h') ? Length::Char : Length::Short;
+      c += (c[1] == 'h') ? 2 : 1;
+    } else if (*c == 'l') {
+      length = (c[1] == 'l') ? Length::LongLong : Length::Long;
+      c += (c[1] == 'l') ? 2 : 1;
+    } else if (*c == 'z') {
+      length = Length::Size;
+      c++;
+    } else if (*c == 'j') {
+      length = Length::Max;
+      c++;
+    } else if (*c == 't') {
+      length = Length::PtrDiff;
+      c++;
+    }
+
+    switch (*c) {
+    case 'd':
+    case 'i': {
+      std::intmax_t value { 0 };
+      switch (length) {
+      case Length::Char:
+        value = static_cast<signed char>(va_arg(args, int));
+        break;
+      case Length::Short:
+        value = static_cast<short>(va_arg(args, int));
+        break;
+      case Length::Long:
+        value = va_arg(args, long);
+        break;
+      case Length::LongLong:
+        value = va_arg(args, long long);
+        break;
+      case Length::Size:
+      case Length::PtrDiff:
+        value = va_arg(args, std::ptrdiff_t);
+        break;
+      case Length::Max:
+        value = va_arg(args, std::intmax_t);
+        break;
+      default:
+        value = va_arg(args, int);
+        break;
+      }
+      std::uintmax_t const magnitude = value < 0 ? -static_cast<std::uintmax_t>(value)
+                                                 : static_cast<std::uintmax_t>(value);
+      formatNumber(output, spec, magnitude, value < 0, 10, false, "");
+      break;
+    }
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o': {
+      std::uintmax_t value { 0 };
+      switch (length) {
+      case Length::Char:
+        value = static_cast<unsigned char>(va_arg(args, unsigned));
+        break;
+      case Length::Short:
+        value = static_cast<unsigned short>(va_arg(args, unsigned));
+        break;
+      case Length::Long:
+        value = va_arg(args, unsigned long);
+        break;
+      case Length::LongLong:
+        value = va_arg(args, unsigned long long);
+        break;
+      case Length::Size:
+      case Length::PtrDiff:
+        value = va_arg(args, std::size_t);
+        break;
+      case Length::Max:
+        value = va_arg(args, std::uintmax_t);
+        break;
+      default:
+        value = va_arg(args, unsigned);
+        break;
+      }
+      spec.plus = false;
+      spec.space = false;
+      unsigned const base = (*c == 'o') ? 8 : (*c == 'u' ? 10 : 16);
+      formatNumber(output, spec, value, false, base, *c == 'X', "");
+      break;
+    }
+    case 'p': {
+      Spec pointerSpec { };
+      pointerSpec.width = spec.width;
+      pointerSpec.leftAlign = spec.leftAlign;
+      formatNumber(output, pointerSpec, reinterpret_cast<std::uintptr_t>(va_arg(args, void*)), false, 16, false,
+                   "0x");
+      break;
+    }
+    case 'c': {
+      char const text[2] { static_cast<char>(va_arg(args, int)), '\0' };
+      Spec characterSpec { spec };
+      characterSpec.precision = 1;
+      if (text[0] == '\0') {
+        // Null character is still a character
+        output.repeat(' ', spec.leftAlign ? 0 : spec.width - 1);
+        output.put('\0');
+        output.repeat(' ', spec.leftAlign ? spec.width - 1 : 0);
+      } else {
+        formatText(output, characterSpec, text);
+      }
+      break;
+    }
+    case 's':
+      formatText(output, spec, va_arg(args, char const*));
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      // No floating point support, but the argument has to be consumed to keep the rest in sync
+      (void) va_arg(args, double);
+      output.put('?');
+      break;
+    case '%':
+      output.put('%');
+      break;
+    case '\0':
+      c--;
+      break;
+    default:
+      output.put('%');
+      output.put(*c);
+      break;
+    }
+  }
+
+  output.terminate();
+  return static_cast<int>(output.length());
+}
+
+}
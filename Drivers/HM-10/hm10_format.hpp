@@ -0,0 +1,26 @@
+/*
+ * hm10_format.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Minimal vsnprintf replacement, used by the driver in HM10_STATIC_ALLOCATION mode.
+ * newlib's vsnprintf can call malloc (via _sbrk), this one never touches the heap and is re-entrant.
+ *
+ * Supported: %d %i %u %x %X %o %c %s %p %%, flags `-`, `0`, `+`, ` `, width and precision (also `*`),
+ * length modifiers hh, h, l, ll, z, j, t. Floating point conversions consume the argument and print `?`.
+ */
+
+#pragma once
+#include <cstdarg>
+#include <cstddef>
+
+namespace HM10 {
+
+// Works like vsnprintf - always null-terminates (if size > 0), returns the length of the whole formatted
+// string (even if it was truncated).
+int formatString(char* buffer, std::size_t size, char const* format, std::va_list args);
+
+}
@@ -0,0 +1,128 @@
+/*
+ * hm10_link_quality.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_link_quality.hpp"
+
+#include <cstring>
+
+namespace HM10 {
+
+LinkQualitySampler::LinkQualitySampler(HM10& module)
+    : m_module(module) {
+}
+
+void LinkQualitySampler::setPeriod(std::uint32_t period) {
+  m_period = period;
+}
+
+void LinkQualitySampler::setQuietTime(std::uint32_t quietTime) {
+  m_quietTime = quietTime;
+}
+
+void LinkQualitySampler::setAverageShift(std::uint8_t shift) {
+  m_averageShift = (shift < 8 ? shift : 7);
+}
+
+bool LinkQualitySampler::poll() {
+  std::uint32_t const now = platformTicks();
+  if (m_local.samples + m_local.failedSamples > 0 && now - m_lastSampleTime < m_period) {
+    return false;
+  }
+
+  if (!m_module.isConnected()) {
+    return false;
+  }
+
+  if (m_module.isBusy() || now - m_module.lastDataActivity() < m_quietTime) {
+    // One skip per missed period, so the counter doesn't depend on how often `poll()` is called
+    if (!m_skipCounted || now - m_lastSkipTime >= m_period) {
+      m_lastSkipTime = now;
+      m_skipCounted = true;
+      m_local.skippedSamples++;
+      publish(m_local);
+    }
+    return false;
+  }
+
+  m_lastSampleTime = now;
+  m_skipCounted = false;
+  int const rssi = m_module.rssi();
+  if (rssi >= 0 || rssi < -127) {
+    m_local.failedSamples++;
+    publish(m_local);
+    return false;
+  }
+
+  std::int8_t const sample = static_cast<std::int8_t>(rssi);
+  if (m_local.samples == 0) {
+    m_local.minRSSI = sample;
+    m_local.maxRSSI = sample;
+    m_local.averageRSSI = static_cast<std::int16_t>(sample * 16);
+  } else {
+    if (sample < m_local.minRSSI) {
+      m_local.minRSSI = sample;
+    }
+    if (sample > m_local.maxRSSI) {
+      m_local.maxRSSI = sample;
+    }
+    int const average = m_local.averageRSSI;
+    m_local.averageRSSI = static_cast<std::int16_t>(average + (sample * 16 - average) / (1 << m_averageShift));
+  }
+
+  m_local.lastRSSI = sample;
+  m_local.timestamp = platformTicks();
+  m_local.samples++;
+  publish(m_local);
+  return true;
+}
+
+LinkQuality LinkQualitySampler::snapshot() const {
+  std::uint32_t words[CopyWords] { };
+  while (true) {
+    std::uint32_t const before = m_sequence.load(std::memory_order_acquire);
+    // Published copy - the one the writer doesn't touch until it starts the update after the next one
+    std::size_t const copy = (before / 2) % 2;
+    for (std::size_t i = 0; i < CopyWords; i++) {
+      words[i] = m_copies[copy][i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint32_t const after = m_sequence.load(std::memory_order_relaxed);
+
+    // Writing into this copy starts at (before rounded down to even) + 3, any value below means it's intact
+    if (after - (before & ~1u) <= 2) {
+      break;
+    }
+  }
+
+  LinkQuality quality { };
+  std::memcpy(&quality, words, sizeof(quality));
+  return quality;
+}
+
+void LinkQualitySampler::reset() {
+  m_local = LinkQuality { };
+  m_skipCounted = false;
+  publish(m_local);
+}
+
+void LinkQualitySampler::publish(LinkQuality const& quality) {
+  // Single writer - the thread calling `poll()`
+  std::uint32_t words[CopyWords] { };
+  std::memcpy(words, &quality, sizeof(quality));
+
+  std::uint32_t const sequence = m_sequence.load(std::memory_order_relaxed);
+  std::size_t const copy = (sequence / 2 + 1) % 2;
+  m_sequence.store(sequence + 1, std::memory_order_relaxed);
+  // A reader that sees any of the new words also sees the odd sequence above
+  std::atomic_thread_fence(std::memory_order_release);
+  for (std::size_t i = 0; i < CopyWords; i++) {
+    m_copies[copy][i].store(words[i], std::memory_order_relaxed);
+  }
+  m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+}
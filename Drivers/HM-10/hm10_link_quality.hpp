@@ -0,0 +1,83 @@
+/*
+ * hm10_link_quality.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Periodic RSSI sampler.
+ * Call `poll()` from the thread that owns HM10 object (it's blocking for the AT+RSSI? round trip),
+ * and read the statistics with `snapshot()` from any task. It's lock-free: the writer fills one of two copies
+ * while the readers take the other one, so a reader never waits for a preempted writer, and it retries only
+ * when two whole updates happen during its copy. It never returns half-updated data.
+ * Sampling is skipped when the application data was sent or received recently, so it won't
+ * stall the data path.
+ * Samples come from `HM10::rssi()` - the peer must be an HM-10 in remote control mode (AT+MODE2) to answer them.
+ */
+
+#pragma once
+#include "hm10.hpp"
+
+#include <atomic>
+
+namespace HM10 {
+
+struct LinkQuality {
+  // All RSSI values are in dBm, average is in 1/16 dBm
+  std::int8_t lastRSSI { 0 };
+  std::int8_t minRSSI { 0 };
+  std::int8_t maxRSSI { 0 };
+  std::int16_t averageRSSI { 0 };
+  // Tick of the last sample
+  std::uint32_t timestamp { 0 };
+  std::uint32_t samples { 0 };
+  // Samples skipped because of data traffic, or failed
+  std::uint32_t skippedSamples { 0 };
+  std::uint32_t failedSamples { 0 };
+
+  int average() const {
+    return averageRSSI / 16;
+  }
+};
+
+class LinkQualitySampler {
+public:
+  LinkQualitySampler(HM10& module);
+
+  // Minimum time between samples, in ms
+  void setPeriod(std::uint32_t period);
+  // Sample is not taken if there was any data transfer in last `quietTime` ms
+  void setQuietTime(std::uint32_t quietTime);
+  // Average weight is 1/2^shift
+  void setAverageShift(std::uint8_t shift);
+
+  // Takes a sample if it's time to do it and the link is quiet. Returns `true` if the sample was taken.
+  bool poll();
+
+  // Safe to call from any task, doesn't block or mask the interrupts
+  LinkQuality snapshot() const;
+  void reset();
+
+private:
+  void publish(LinkQuality const& quality);
+
+  HM10& m_module;
+
+  std::uint32_t m_period { 1000 };
+  std::uint32_t m_quietTime { 50 };
+  std::uint8_t m_averageShift { 3 };
+  std::uint32_t m_lastSampleTime { 0 };
+  // Traffic skips are counted once per period
+  std::uint32_t m_lastSkipTime { 0 };
+  bool m_skipCounted { false };
+
+  // Writer-owned copy, published to one of m_copies (as atomic words, so the concurrent copy isn't a data race).
+  // m_sequence is odd while the writer fills the copy, and the published copy is (m_sequence / 2) % 2.
+  static constexpr std::size_t CopyWords { (sizeof(LinkQuality) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t) };
+  LinkQuality m_local { };
+  std::atomic<std::uint32_t> m_copies[2][CopyWords] { };
+  std::atomic<std::uint32_t> m_sequence { 0 };
+};
+
+}
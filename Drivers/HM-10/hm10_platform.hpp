@@ -0,0 +1,58 @@
+/*
+ * hm10_platform.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Small platform helpers shared by the driver internals - interrupt masking and cycle counter.
+ * On the host, the HAL shim provides PRIMASK functions and the cycle counter is steady clock in nanoseconds.
+ */
+
+#pragma once
+#include <stm32f4xx.h>
+#include <cstdint>
+
+#ifdef HM10_HOST_BUILD
+#include <chrono>
+#endif
+
+namespace HM10 {
+
+// Masks the interrupts for its lifetime, restores the previous state (so it can be nested)
+class CriticalSection {
+public:
+  CriticalSection()
+      : m_primask(__get_PRIMASK()) {
+    __disable_irq();
+  }
+
+  ~CriticalSection() {
+    __set_PRIMASK(m_primask);
+  }
+
+  CriticalSection(CriticalSection const&) = delete;
+  CriticalSection& operator=(CriticalSection const&) = delete;
+
+private:
+  std::uint32_t m_primask;
+};
+
+inline void enableCycleCounter() {
+#ifndef HM10_HOST_BUILD
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+inline std::uint32_t cycleCounter() {
+#ifdef HM10_HOST_BUILD
+  using namespace std::chrono;
+  return static_cast<std::uint32_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#else
+  return DWT->CYCCNT;
+#endif
+}
+
+}
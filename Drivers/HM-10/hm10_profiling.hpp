@@ -0,0 +1,105 @@
+/*
+ * hm10_profiling.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Optional execution time measurement of the driver hot paths.
+ * Define HM10_PROFILING to enable it, otherwise it compiles to nothing.
+ *
+ * On the MCU the time is measured in CPU cycles, with DWT cycle counter (enabled in `HM10::initialize()`).
+ * On the host it's measured in nanoseconds, using steady clock.
+ * Results are available via `HM10::stats()`.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#ifdef HM10_PROFILING
+#include "hm10_platform.hpp"
+
+namespace HM10 {
+
+enum class ProfilingSite : std::uint8_t {
+  ReceiveCompleted = 0,
+  TransmitCompleted,
+  TransmitAndReceive,
+  Count
+};
+
+struct SiteStatistics {
+  // Every bucket counts the samples with given bit width, so bucket N holds [2^(N-1), 2^N) cycles.
+  static constexpr std::size_t HistogramBuckets { 33 };
+
+  std::uint32_t calls { 0 };
+  std::uint32_t minCycles { 0 };
+  std::uint32_t maxCycles { 0 };
+  std::uint64_t totalCycles { 0 };
+  std::uint32_t histogram[HistogramBuckets] { };
+
+  std::uint32_t meanCycles() const {
+    return calls > 0 ? static_cast<std::uint32_t>(totalCycles / calls) : 0;
+  }
+};
+
+struct ProfilingStatistics {
+  SiteStatistics sites[static_cast<std::size_t>(ProfilingSite::Count)] { };
+
+  SiteStatistics const& operator[](ProfilingSite site) const {
+    return sites[static_cast<std::size_t>(site)];
+  }
+
+  SiteStatistics& operator[](ProfilingSite site) {
+    return sites[static_cast<std::size_t>(site)];
+  }
+
+  void record(ProfilingSite site, std::uint32_t cycles) {
+    SiteStatistics& statistics = (*this)[site];
+    if (statistics.calls == 0 || cycles < statistics.minCycles) {
+      statistics.minCycles = cycles;
+    }
+    if (cycles > statistics.maxCycles) {
+      statistics.maxCycles = cycles;
+    }
+    statistics.calls++;
+    statistics.totalCycles += cycles;
+    statistics.histogram[cycles == 0 ? 0 : 32 - __builtin_clz(cycles)]++;
+  }
+};
+
+namespace Profiling {
+
+// Measures the time between construction and destruction, so every return path is covered
+class ScopedMeasurement {
+public:
+  ScopedMeasurement(ProfilingStatistics& statistics, ProfilingSite site)
+      : m_statistics(statistics), m_site(site), m_start(cycleCounter()) {
+  }
+
+  ~ScopedMeasurement() {
+    std::uint32_t const elapsed = cycleCounter() - m_start;
+    // Same statistics are updated from ISRs and the task
+    CriticalSection const criticalSection { };
+    m_statistics.record(m_site, elapsed);
+  }
+
+  ScopedMeasurement(ScopedMeasurement const&) = delete;
+  ScopedMeasurement& operator=(ScopedMeasurement const&) = delete;
+
+private:
+  ProfilingStatistics& m_statistics;
+  ProfilingSite m_site;
+  std::uint32_t m_start;
+};
+
+}
+
+}
+
+#define HM10_PROFILE(statistics, site) ::HM10::Profiling::ScopedMeasurement hm10ProfilingScope { statistics, site }
+#else
+#define HM10_PROFILE(statistics, site)
+#endif
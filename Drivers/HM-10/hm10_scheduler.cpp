@@ -0,0 +1,153 @@
+/*
+ * hm10_scheduler.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_scheduler.hpp"
+#include "hm10_platform.hpp"
+#include <cstring>
+
+namespace HM10 {
+
+TransferScheduler::TransferScheduler(HM10& module)
+    : m_module(module) {
+}
+
+void TransferScheduler::setAgingTime(std::uint32_t agingTime) {
+  m_agingTime = agingTime;
+}
+
+bool TransferScheduler::submitData(std::uint8_t const* data, std::size_t length, TransferPriority priority) {
+  return submit(priority, nullptr, nullptr, data, length);
+}
+
+bool TransferScheduler::submitJob(JobT job, void* context, TransferPriority priority) {
+  if (job == nullptr) {
+    return false;
+  }
+  return submit(priority, job, context, nullptr, 0);
+}
+
+bool TransferScheduler::dispatch() {
+  std::uint32_t const now = platformTicks();
+  bool aged { false };
+  int const index = selectQueue(now, aged);
+  if (index < 0) {
+    return false;
+  }
+
+  Queue& queue = m_queues[index];
+  // Producers never touch the item at tail, so it can be used without the lock
+  Item const& item = queue.items[queue.tail % HM10_SCHEDULER_QUEUE_LENGTH];
+  std::uint32_t const waitTime = now - item.submitTime;
+
+  bool success { true };
+  if (item.job != nullptr) {
+    item.job(m_module, item.context);
+  } else {
+    success = m_module.sendData(item.data, item.length);
+  }
+
+  CriticalSection const criticalSection { };
+  queue.tail++;
+  SchedulerStatistics& statistics = queue.statistics;
+  statistics.dispatched++;
+  statistics.failed += success ? 0 : 1;
+  statistics.aged += aged ? 1 : 0;
+  statistics.totalWaitTime += waitTime;
+  if (waitTime > statistics.maxWaitTime) {
+    statistics.maxWaitTime = waitTime;
+  }
+  return true;
+}
+
+std::size_t TransferScheduler::dispatchAll() {
+  std::size_t dispatched { 0 };
+  while (dispatch()) {
+    dispatched++;
+  }
+  return dispatched;
+}
+
+std::size_t TransferScheduler::pending(TransferPriority priority) const {
+  CriticalSection const criticalSection { };
+  Queue const& queue = m_queues[static_cast<std::size_t>(priority)];
+  return queue.head - queue.tail;
+}
+
+SchedulerStatistics TransferScheduler::statistics(TransferPriority priority) const {
+  CriticalSection const criticalSection { };
+  return m_queues[static_cast<std::size_t>(priority)].statistics;
+}
+
+void TransferScheduler::resetStatistics() {
+  CriticalSection const criticalSection { };
+  for (Queue& queue : m_queues) {
+    queue.statistics = SchedulerStatistics { };
+  }
+}
+
+bool TransferScheduler::submit(TransferPriority priority, JobT job, void* context, std::uint8_t const* data,
+                               std::size_t length) {
+  std::size_t const index = static_cast<std::size_t>(priority);
+  if (index >= TransferPriorityCount) {
+    return false;
+  }
+  Queue& queue = m_queues[index];
+
+  // Copy is small (up to HM10_BUFFER_SIZE), so it's done with interrupts masked - that's simpler
+  // than reserving the item, and works with any amount of producers
+  CriticalSection const criticalSection { };
+  if (length > HM10_BUFFER_SIZE || queue.head - queue.tail >= HM10_SCHEDULER_QUEUE_LENGTH) {
+    queue.statistics.dropped++;
+    return false;
+  }
+
+  Item& item = queue.items[queue.head % HM10_SCHEDULER_QUEUE_LENGTH];
+  item.job = job;
+  item.context = context;
+  item.length = length;
+  if (length > 0) {
+    std::memcpy(item.data, data, length);
+  }
+  item.submitTime = platformTicks();
+  queue.head++;
+  queue.statistics.submitted++;
+  return true;
+}
+
+int TransferScheduler::selectQueue(std::uint32_t now, bool& aged) const {
+  CriticalSection const criticalSection { };
+  int selected { -1 };
+  int highestNonEmpty { -1 };
+  std::uint32_t selectedLevel { 0 };
+  std::uint32_t selectedWait { 0 };
+
+  for (std::size_t i = 0; i < TransferPriorityCount; i++) {
+    Queue const& queue = m_queues[i];
+    if (queue.head == queue.tail) {
+      continue;
+    }
+    if (highestNonEmpty < 0) {
+      highestNonEmpty = static_cast<int>(i);
+    }
+
+    std::uint32_t const wait = now - queue.items[queue.tail % HM10_SCHEDULER_QUEUE_LENGTH].submitTime;
+    std::uint32_t const promotion = (m_agingTime > 0 ? wait / m_agingTime : 0);
+    std::uint32_t const level = (promotion >= i ? 0 : i - promotion);
+
+    // Queues are checked from the most important, so on equal level and wait time it stays first
+    if (selected < 0 || level < selectedLevel || (level == selectedLevel && wait > selectedWait)) {
+      selected = static_cast<int>(i);
+      selectedLevel = level;
+      selectedWait = wait;
+    }
+  }
+
+  aged = (selected != highestNonEmpty);
+  return selected;
+}
+
+}
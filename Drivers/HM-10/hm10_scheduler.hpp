@@ -0,0 +1,108 @@
+/*
+ * hm10_scheduler.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Priority-aware transfer scheduler.
+ * Any task can submit data or command jobs, and the thread that owns HM10 object runs them with `dispatch()`.
+ * There are three queues - urgent data, normal data and housekeeping (AT commands: RSSI polls, configuration...).
+ * The queue with the highest priority always goes first, but the waiting items age - every `agingTime` ms
+ * of waiting moves the item one priority level up, and when the levels are equal, the oldest item wins.
+ * So housekeeping yields to the data, but it's never starved, and the urgent data never waits for more than
+ * the transfer that's already running plus the items that aged up to the urgent level.
+ *
+ * A transfer that already started is never interrupted, so keep the housekeeping jobs short
+ * (one command per job) - the worst-case urgent data latency is the longest job timeout.
+ */
+
+#pragma once
+#include "hm10.hpp"
+
+// Amount of items in every priority queue
+#ifndef HM10_SCHEDULER_QUEUE_LENGTH
+#define HM10_SCHEDULER_QUEUE_LENGTH 8
+#endif
+
+namespace HM10 {
+
+enum class TransferPriority : std::uint8_t {
+  Urgent = 0,
+  Normal = 1,
+  Housekeeping = 2
+};
+
+constexpr std::size_t TransferPriorityCount { 3 };
+
+// All times are in ms (RTOS ticks)
+struct SchedulerStatistics {
+  std::uint32_t submitted { 0 };
+  std::uint32_t dispatched { 0 };
+  // Rejected because the queue was full
+  std::uint32_t dropped { 0 };
+  // Data items that failed to send (for example, the module was not connected)
+  std::uint32_t failed { 0 };
+  // Items that were dispatched thanks to aging
+  std::uint32_t aged { 0 };
+  std::uint32_t maxWaitTime { 0 };
+  std::uint32_t totalWaitTime { 0 };
+
+  std::uint32_t averageWaitTime() const {
+    return dispatched > 0 ? totalWaitTime / dispatched : 0;
+  }
+};
+
+class TransferScheduler {
+public:
+  // Housekeeping job, called from `dispatch()` with the module and the context passed to `submitJob`
+  using JobT = void(*)(HM10&, void*);
+
+  TransferScheduler(HM10& module);
+
+  // Every `agingTime` ms of waiting raises the item priority by one level. 0 disables aging (strict priority).
+  void setAgingTime(std::uint32_t agingTime);
+
+  // Can be called from any task. Data is copied into the queue (up to HM10_BUFFER_SIZE bytes).
+  // Returns `false` if the queue is full or the data is too long.
+  bool submitData(std::uint8_t const* data, std::size_t length,
+                  TransferPriority priority = TransferPriority::Normal);
+  bool submitJob(JobT job, void* context, TransferPriority priority = TransferPriority::Housekeeping);
+
+  // Call from the thread that owns HM10 object. Runs the most important item, returns `false` if there was none.
+  bool dispatch();
+  // Runs the items until the queues are empty. Returns the amount of dispatched items.
+  std::size_t dispatchAll();
+
+  std::size_t pending(TransferPriority priority) const;
+  SchedulerStatistics statistics(TransferPriority priority) const;
+  void resetStatistics();
+
+private:
+  struct Item {
+    JobT job { nullptr };
+    void* context { nullptr };
+    std::uint8_t data[HM10_BUFFER_SIZE] { };
+    std::size_t length { 0 };
+    std::uint32_t submitTime { 0 };
+  };
+
+  struct Queue {
+    Item items[HM10_SCHEDULER_QUEUE_LENGTH] { };
+    // Free-running indexes. Producers fill the item at `head` with interrupts masked, and the dispatcher
+    // releases the item at `tail` only after it's done with it, so it's used without copying.
+    std::size_t head { 0 };
+    std::size_t tail { 0 };
+    SchedulerStatistics statistics { };
+  };
+
+  bool submit(TransferPriority priority, JobT job, void* context, std::uint8_t const* data, std::size_t length);
+  int selectQueue(std::uint32_t now, bool& aged) const;
+
+  HM10& m_module;
+  std::uint32_t m_agingTime { 200 };
+  Queue m_queues[TransferPriorityCount] { };
+};
+
+}
@@ -0,0 +1,137 @@
+/*
+ * hm10_service.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_service.hpp"
+
+#ifdef USE_RTOS_DELAY
+
+namespace HM10 {
+
+namespace {
+
+struct SendDataArguments {
+  std::uint8_t const* data;
+  std::size_t length;
+};
+
+}
+
+HM10Service::HM10Service(HM10& module)
+    : m_module(module) {
+}
+
+bool HM10Service::start() {
+  if (isRunning()) {
+    return true;
+  }
+
+  osMessageQueueAttr_t queueAttributes { };
+  queueAttributes.name = "hm10Requests";
+  queueAttributes.cb_mem = &m_queueControlBlock;
+  queueAttributes.cb_size = sizeof(m_queueControlBlock);
+  queueAttributes.mq_mem = &m_queueStorage[0];
+  queueAttributes.mq_size = sizeof(m_queueStorage);
+  m_queue = osMessageQueueNew(HM10_SERVICE_QUEUE_LENGTH, sizeof(Request), &queueAttributes);
+  if (m_queue == nullptr) {
+    return false;
+  }
+
+  osThreadAttr_t taskAttributes { };
+  taskAttributes.name = "hm10Service";
+  taskAttributes.cb_mem = &m_taskControlBlock;
+  taskAttributes.cb_size = sizeof(m_taskControlBlock);
+  taskAttributes.stack_mem = &m_taskStack[0];
+  taskAttributes.stack_size = sizeof(m_taskStack);
+  taskAttributes.priority = HM10_SERVICE_PRIORITY;
+  m_task = osThreadNew(taskEntry, this, &taskAttributes);
+  return m_task != nullptr;
+}
+
+bool HM10Service::isRunning() const {
+  return m_task != nullptr;
+}
+
+bool HM10Service::call(RequestT request, void* context) {
+  if (!isRunning() || request == nullptr) {
+    return false;
+  }
+
+  bool result { false };
+  Request const message { request, context, osThreadGetId(), &result };
+  if (osMessageQueuePut(m_queue, &message, 0, osWaitForever) != osOK) {
+    return false;
+  }
+
+  osThreadFlagsWait(HM10_SERVICE_THREAD_FLAG, osFlagsWaitAny, osWaitForever);
+  return result;
+}
+
+bool HM10Service::post(RequestT request, void* context, std::uint32_t timeout) {
+  if (!isRunning() || request == nullptr) {
+    return false;
+  }
+
+  Request const message { request, context, nullptr, nullptr };
+  return osMessageQueuePut(m_queue, &message, 0, timeout) == osOK;
+}
+
+bool HM10Service::isAlive() {
+  return call([](HM10& module, void*) {
+    return module.isAlive();
+  }, nullptr);
+}
+
+bool HM10Service::sendData(std::uint8_t const* data, std::size_t length) {
+  SendDataArguments arguments { data, length };
+  return call([](HM10& module, void* context) {
+    SendDataArguments const* const arguments = static_cast<SendDataArguments const*>(context);
+    return module.sendData(arguments->data, arguments->length);
+  }, &arguments);
+}
+
+int HM10Service::rssi() {
+  int value { 0 };
+  call([](HM10& module, void* context) {
+    *static_cast<int*>(context) = module.rssi();
+    return true;
+  }, &value);
+  return value;
+}
+
+std::uint32_t HM10Service::handledRequests() const {
+  return m_handledRequests.load(std::memory_order_relaxed);
+}
+
+std::size_t HM10Service::pendingRequests() const {
+  return isRunning() ? osMessageQueueGetCount(m_queue) : 0;
+}
+
+void HM10Service::taskEntry(void* argument) {
+  static_cast<HM10Service*>(argument)->run();
+}
+
+void HM10Service::run() {
+  while (true) {
+    Request request { };
+    if (osMessageQueueGet(m_queue, &request, nullptr, osWaitForever) != osOK) {
+      continue;
+    }
+
+    bool const result = request.request(m_module, request.context);
+    m_handledRequests.fetch_add(1, std::memory_order_relaxed);
+
+    // The result has to be stored before the caller is woken up, it's on the caller's stack
+    if (request.caller != nullptr) {
+      *request.result = result;
+      osThreadFlagsSet(request.caller, HM10_SERVICE_THREAD_FLAG);
+    }
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * hm10_service.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * HM10 object is not thread-safe - calling its methods from two tasks corrupts the TX and message buffers.
+ * HM10Service owns the module in its own task, and the other tasks send it requests through a message queue.
+ * Every request is a function called with the module in the service task, so any sequence of HM10 calls
+ * can be done as one request, without a global mutex around the whole round trip.
+ * The caller waits for the result on a thread flag (task notification on FreeRTOS), so it doesn't need
+ * any other synchronization object.
+ *
+ * Task, its stack, message queue and their control blocks are all members of the service object,
+ * nothing is allocated from the heap. Initialize the module and set its callbacks before `start()`.
+ *
+ *   HM10::HM10Service service(hm10);
+ *   hm10.initialize();
+ *   service.start();
+ *   // from any task:
+ *   service.sendData(data, length);
+ *   int rssi { 0 };
+ *   service.call([](HM10::HM10& module, void* result) {
+ *     *static_cast<int*>(result) = module.rssi();
+ *     return true;
+ *   }, &rssi);
+ */
+
+#pragma once
+#include "hm10.hpp"
+#include <atomic>
+
+#ifdef USE_RTOS_DELAY
+#include <FreeRTOS.h>
+
+// Amount of requests that can wait in the queue
+#ifndef HM10_SERVICE_QUEUE_LENGTH
+#define HM10_SERVICE_QUEUE_LENGTH 8
+#endif
+
+// Service task stack size, in bytes
+#ifndef HM10_SERVICE_STACK_SIZE
+#define HM10_SERVICE_STACK_SIZE 2048
+#endif
+
+#ifndef HM10_SERVICE_PRIORITY
+#define HM10_SERVICE_PRIORITY osPriorityAboveNormal
+#endif
+
+// Thread flag used to notify the caller about request completion, must not be used by the caller for anything else
+#ifndef HM10_SERVICE_THREAD_FLAG
+#define HM10_SERVICE_THREAD_FLAG 0x00010000U
+#endif
+
+namespace HM10 {
+
+class HM10Service {
+public:
+  // Request executed in the service task. Return value is passed back to the caller of `call`.
+  using RequestT = bool(*)(HM10&, void*);
+
+  HM10Service(HM10& module);
+
+  HM10Service(HM10Service const&) = delete;
+  HM10Service& operator=(HM10Service const&) = delete;
+
+  // Creates the service task and the request queue. Returns `false` if they couldn't be created.
+  // From now on, the module can be used only through the service.
+  bool start();
+  bool isRunning() const;
+
+  // Runs `request(module, context)` in the service task and waits until it's done.
+  // There's no timeout on purpose - the request can use the caller's stack through `context`, so the caller
+  // can't leave before it's done. Driver operations have their own timeouts, so the request will finish.
+  // Returns the request result, or `false` if the request couldn't be queued (service not started).
+  // Can't be called from the service task itself (it'd wait for itself) - in requests, use the module directly.
+  bool call(RequestT request, void* context);
+
+  // Queues the request and returns immediately, `context` must stay valid until the request is done.
+  // Returns `false` if the queue is full for `timeout` ms.
+  bool post(RequestT request, void* context, std::uint32_t timeout = 0);
+
+  // Shortcuts for the most common requests
+  bool isAlive();
+  bool sendData(std::uint8_t const* data, std::size_t length);
+  // Returns 0 on error, like HM10::rssi
+  int rssi();
+
+  // Amount of requests executed by the service task
+  std::uint32_t handledRequests() const;
+  // Amount of requests waiting in the queue
+  std::size_t pendingRequests() const;
+
+private:
+  struct Request {
+    RequestT request;
+    void* context;
+    // nullptr for posted requests
+    osThreadId_t caller;
+    bool* result;
+  };
+
+  static void taskEntry(void* argument);
+  void run();
+
+  HM10& m_module;
+
+  osThreadId_t m_task { nullptr };
+  osMessageQueueId_t m_queue { nullptr };
+
+  StaticTask_t m_taskControlBlock { };
+  std::uint32_t m_taskStack[HM10_SERVICE_STACK_SIZE / sizeof(std::uint32_t)] { };
+  StaticQueue_t m_queueControlBlock { };
+  std::uint8_t m_queueStorage[HM10_SERVICE_QUEUE_LENGTH * sizeof(Request)] { };
+
+  std::atomic<std::uint32_t> m_handledRequests { 0 };
+};
+
+}
+
+#endif
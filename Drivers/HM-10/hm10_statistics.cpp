@@ -0,0 +1,193 @@
+/*
+ * hm10_statistics.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_statistics.hpp"
+#include <stm32f4xx.h>
+#include <cstring>
+#include <initializer_list>
+
+namespace HM10 {
+
+namespace {
+
+std::size_t histogramBucket(std::uint32_t roundTripTime) {
+  std::size_t bucket { 0 };
+  while (roundTripTime > 0 && bucket < CommandStatistics::HistogramBuckets - 1) {
+    roundTripTime >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void increment(std::atomic<std::uint32_t>& counter, std::uint32_t value = 1) {
+  counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint32_t load(std::atomic<std::uint32_t> const& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+
+}
+
+std::size_t commandIndex(char const* command) {
+  if (std::strncmp(command, "AT+", 3) == 0) {
+    command += 3;
+  }
+
+  // Some names are prefixes of the others (AD/ADDR, CON/COSU), so the longest match wins
+  std::size_t bestMatch { UnknownCommand };
+  std::size_t bestLength { 0 };
+  for (std::size_t i = 0; i < KnownCommandCount; i++) {
+    std::size_t const length = std::strlen(CommandNames[i]);
+    if (length > bestLength && std::strncmp(command, CommandNames[i], length) == 0) {
+      bestMatch = i;
+      bestLength = length;
+    }
+  }
+  return bestMatch;
+}
+
+char const* commandName(std::size_t index) {
+  return index < KnownCommandCount ? CommandNames[index] : "?";
+}
+
+void Statistics::commandCompleted(std::size_t command, std::uint32_t roundTripTime) {
+  CommandCounters& counters = m_commands[command < CommandCount ? command : UnknownCommand];
+  increment(counters.count);
+  increment(counters.roundTripHistogram[histogramBucket(roundTripTime)]);
+
+  std::uint32_t maximum = load(counters.maxRoundTripTime);
+  while (roundTripTime > maximum
+      && !counters.maxRoundTripTime.compare_exchange_weak(maximum, roundTripTime, std::memory_order_relaxed)) {
+  }
+}
+
+void Statistics::commandTimedOut(std::size_t command) {
+  CommandCounters& counters = m_commands[command < CommandCount ? command : UnknownCommand];
+  increment(counters.count);
+  increment(counters.timeouts);
+}
+
+void Statistics::responseChecked(std::size_t command, bool expected) {
+  CommandCounters& counters = m_commands[command < CommandCount ? command : UnknownCommand];
+  increment(expected ? counters.expectedResponses : counters.unexpectedResponses);
+}
+
+void Statistics::commandRejected(std::size_t command) {
+  increment(m_commands[command < CommandCount ? command : UnknownCommand].unsupported);
+}
+
+void Statistics::received(std::size_t bytes, bool wrapped) {
+  increment(m_link.bytesReceived, bytes);
+  increment(m_link.framesReceived);
+  if (wrapped) {
+    increment(m_link.dmaWraps);
+  }
+}
+
+void Statistics::transmitted(std::size_t bytes) {
+  increment(m_link.bytesTransmitted, bytes);
+  increment(m_link.framesTransmitted);
+}
+
+void Statistics::dataDropped(std::size_t bytes) {
+  increment(m_link.droppedDataBytes, bytes);
+}
+
+void Statistics::eventDropped() {
+  increment(m_link.droppedEvents);
+}
+
+void Statistics::uartError(std::uint32_t errorCode) {
+  increment(m_link.uartErrors);
+  if ((errorCode & HAL_UART_ERROR_ORE) != 0) {
+    increment(m_link.overruns);
+  }
+  if ((errorCode & HAL_UART_ERROR_FE) != 0) {
+    increment(m_link.framingErrors);
+  }
+  if ((errorCode & HAL_UART_ERROR_NE) != 0) {
+    increment(m_link.noiseErrors);
+  }
+  if ((errorCode & HAL_UART_ERROR_PE) != 0) {
+    increment(m_link.parityErrors);
+  }
+  if ((errorCode & HAL_UART_ERROR_DMA) != 0) {
+    increment(m_link.dmaErrors);
+  }
+}
+
+void Statistics::receptionRestarted(std::size_t discardedBytes, bool success) {
+  increment(success ? m_link.rxRestarts : m_link.rxRestartFailures);
+  increment(m_link.discardedBytes, discardedBytes);
+}
+
+CommandStatistics Statistics::command(std::size_t index) const {
+  CommandStatistics statistics { };
+  if (index >= CommandCount) {
+    return statistics;
+  }
+
+  CommandCounters const& counters = m_commands[index];
+  statistics.count = load(counters.count);
+  statistics.timeouts = load(counters.timeouts);
+  statistics.expectedResponses = load(counters.expectedResponses);
+  statistics.unexpectedResponses = load(counters.unexpectedResponses);
+  statistics.unsupported = load(counters.unsupported);
+  statistics.maxRoundTripTime = load(counters.maxRoundTripTime);
+  for (std::size_t i = 0; i < CommandStatistics::HistogramBuckets; i++) {
+    statistics.roundTripHistogram[i] = load(counters.roundTripHistogram[i]);
+  }
+  return statistics;
+}
+
+LinkStatistics Statistics::link() const {
+  LinkStatistics statistics { };
+  statistics.bytesReceived = load(m_link.bytesReceived);
+  statistics.bytesTransmitted = load(m_link.bytesTransmitted);
+  statistics.framesReceived = load(m_link.framesReceived);
+  statistics.framesTransmitted = load(m_link.framesTransmitted);
+  statistics.dmaWraps = load(m_link.dmaWraps);
+  statistics.uartErrors = load(m_link.uartErrors);
+  statistics.overruns = load(m_link.overruns);
+  statistics.framingErrors = load(m_link.framingErrors);
+  statistics.noiseErrors = load(m_link.noiseErrors);
+  statistics.parityErrors = load(m_link.parityErrors);
+  statistics.dmaErrors = load(m_link.dmaErrors);
+  statistics.rxRestarts = load(m_link.rxRestarts);
+  statistics.rxRestartFailures = load(m_link.rxRestartFailures);
+  statistics.discardedBytes = load(m_link.discardedBytes);
+  statistics.droppedDataBytes = load(m_link.droppedDataBytes);
+  statistics.droppedEvents = load(m_link.droppedEvents);
+  return statistics;
+}
+
+void Statistics::reset() {
+  for (CommandCounters& counters : m_commands) {
+    counters.count.store(0, std::memory_order_relaxed);
+    counters.timeouts.store(0, std::memory_order_relaxed);
+    counters.expectedResponses.store(0, std::memory_order_relaxed);
+    counters.unexpectedResponses.store(0, std::memory_order_relaxed);
+    counters.unsupported.store(0, std::memory_order_relaxed);
+    counters.maxRoundTripTime.store(0, std::memory_order_relaxed);
+    for (std::atomic<std::uint32_t>& bucket : counters.roundTripHistogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  for (std::atomic<std::uint32_t>* counter : { &m_link.bytesReceived, &m_link.bytesTransmitted,
+                                               &m_link.framesReceived, &m_link.framesTransmitted,
+                                               &m_link.dmaWraps, &m_link.uartErrors, &m_link.overruns,
+                                               &m_link.framingErrors, &m_link.noiseErrors,
+                                               &m_link.parityErrors, &m_link.dmaErrors, &m_link.rxRestarts,
+                                               &m_link.rxRestartFailures, &m_link.discardedBytes,
+                                               &m_link.droppedDataBytes, &m_link.droppedEvents }) {
+    counter->store(0, std::memory_order_relaxed);
+  }
+}
+
+}
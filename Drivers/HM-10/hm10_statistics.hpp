@@ -0,0 +1,136 @@
+/*
+ * hm10_statistics.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Per-command and data path statistics.
+ * Counters are updated with relaxed atomics (from the HM10 task and interrupts), so any task
+ * can take a snapshot at any time without locking. Snapshot is not a single consistent point in time,
+ * but every counter in it is valid.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace HM10 {
+
+// Command names, without "AT+" prefix. "AT" is the plain `AT` command, unknown commands are counted
+// in the last, extra entry (see `CommandCount`).
+constexpr char const* CommandNames[] = {
+  "AT", "AD", "ADDR", "ADTY", "ADVI", "ALLO", "BAUD", "CHAR", "CLEAR", "COLA", "COMA", "COMI", "CON", "CONNL",
+  "COSU", "COUP", "DISI", "ERASE", "FFE2", "GAIN", "IMME", "MODE", "NAME", "NOTI", "NOTP", "PACK", "PASS", "PCTL",
+  "POWE", "PWRM", "RELI", "RENEW", "RESET", "ROLE", "RSSI", "SLEEP", "START", "TYPE", "UART", "UUID", "VERR"
+};
+
+constexpr std::size_t KnownCommandCount { sizeof(CommandNames) / sizeof(CommandNames[0]) };
+constexpr std::size_t UnknownCommand { KnownCommandCount };
+constexpr std::size_t CommandCount { KnownCommandCount + 1 };
+
+// Returns the index of the command in `CommandNames`, or `UnknownCommand`.
+// Accepts both the command as it's transmitted ("AT+NAME?") and the bare name ("NAME").
+std::size_t commandIndex(char const* command);
+char const* commandName(std::size_t index);
+
+struct CommandStatistics {
+  // Bucket N counts round trips with bit width N of the time in ms, so bucket 0 is <1ms,
+  // bucket 1 - 1ms, bucket 2 - [2, 4)ms, bucket 3 - [4, 8)ms... and the last one everything above.
+  static constexpr std::size_t HistogramBuckets { 12 };
+
+  std::uint32_t count { 0 };
+  std::uint32_t timeouts { 0 };
+  // Response checked against the expected one (most of the commands)
+  std::uint32_t expectedResponses { 0 };
+  std::uint32_t unexpectedResponses { 0 };
+  // Rejected without transmitting, because the detected firmware doesn't support the command (not in `count`)
+  std::uint32_t unsupported { 0 };
+  std::uint32_t maxRoundTripTime { 0 };
+  std::uint32_t roundTripHistogram[HistogramBuckets] { };
+};
+
+struct LinkStatistics {
+  // All the bytes received and transmitted via UART, including commands and responses
+  std::uint32_t bytesReceived { 0 };
+  std::uint32_t bytesTransmitted { 0 };
+  // Messages separated by idle line
+  std::uint32_t framesReceived { 0 };
+  std::uint32_t framesTransmitted { 0 };
+  // Messages split by circular DMA buffer rollover
+  std::uint32_t dmaWraps { 0 };
+  // UART errors, from `HM10::errorOccurred()`. One error callback can have more than one error bit set.
+  std::uint32_t uartErrors { 0 };
+  std::uint32_t overruns { 0 };
+  std::uint32_t framingErrors { 0 };
+  std::uint32_t noiseErrors { 0 };
+  std::uint32_t parityErrors { 0 };
+  std::uint32_t dmaErrors { 0 };
+  // Receptions restarted after the error stopped RX DMA, failed restarts, and the bytes of the unfinished
+  // message that were thrown away
+  std::uint32_t rxRestarts { 0 };
+  std::uint32_t rxRestartFailures { 0 };
+  std::uint32_t discardedBytes { 0 };
+  // Application data that didn't fit into the stream/message buffer (see HM10::setDataStreamBuffer)
+  std::uint32_t droppedDataBytes { 0 };
+  // Deferred callback events that didn't fit into the queue (see CallbackDispatch::Deferred)
+  std::uint32_t droppedEvents { 0 };
+};
+
+class Statistics {
+public:
+  void commandCompleted(std::size_t command, std::uint32_t roundTripTime);
+  void commandTimedOut(std::size_t command);
+  void responseChecked(std::size_t command, bool expected);
+  void commandRejected(std::size_t command);
+
+  void received(std::size_t bytes, bool wrapped);
+  void transmitted(std::size_t bytes);
+  void uartError(std::uint32_t errorCode);
+  void receptionRestarted(std::size_t discardedBytes, bool success);
+  void dataDropped(std::size_t bytes);
+  void eventDropped();
+
+  CommandStatistics command(std::size_t index) const;
+  LinkStatistics link() const;
+
+  // Not atomic as a whole - counters updated during the reset may survive it
+  void reset();
+
+private:
+  struct CommandCounters {
+    std::atomic<std::uint32_t> count { 0 };
+    std::atomic<std::uint32_t> timeouts { 0 };
+    std::atomic<std::uint32_t> expectedResponses { 0 };
+    std::atomic<std::uint32_t> unexpectedResponses { 0 };
+    std::atomic<std::uint32_t> unsupported { 0 };
+    std::atomic<std::uint32_t> maxRoundTripTime { 0 };
+    std::atomic<std::uint32_t> roundTripHistogram[CommandStatistics::HistogramBuckets] { };
+  };
+
+  struct LinkCounters {
+    std::atomic<std::uint32_t> bytesReceived { 0 };
+    std::atomic<std::uint32_t> bytesTransmitted { 0 };
+    std::atomic<std::uint32_t> framesReceived { 0 };
+    std::atomic<std::uint32_t> framesTransmitted { 0 };
+    std::atomic<std::uint32_t> dmaWraps { 0 };
+    std::atomic<std::uint32_t> uartErrors { 0 };
+    std::atomic<std::uint32_t> overruns { 0 };
+    std::atomic<std::uint32_t> framingErrors { 0 };
+    std::atomic<std::uint32_t> noiseErrors { 0 };
+    std::atomic<std::uint32_t> parityErrors { 0 };
+    std::atomic<std::uint32_t> dmaErrors { 0 };
+    std::atomic<std::uint32_t> rxRestarts { 0 };
+    std::atomic<std::uint32_t> rxRestartFailures { 0 };
+    std::atomic<std::uint32_t> discardedBytes { 0 };
+    std::atomic<std::uint32_t> droppedDataBytes { 0 };
+    std::atomic<std::uint32_t> droppedEvents { 0 };
+  };
+
+  CommandCounters m_commands[CommandCount] { };
+  LinkCounters m_link { };
+};
+
+}
@@ -0,0 +1,141 @@
+/*
+ * hm10_supervisor.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_supervisor.hpp"
+#include "hm10_debug.hpp"
+#include "hm10_platform.hpp"
+#include <cstring>
+
+namespace HM10 {
+
+namespace {
+
+bool passed(std::uint32_t now, std::uint32_t deadline) {
+  return static_cast<std::int32_t>(now - deadline) >= 0;
+}
+
+}
+
+LinkSupervisor::LinkSupervisor(HM10& module, Role role)
+    : m_module(module), m_role(role) {
+}
+
+void LinkSupervisor::setPeer(char const* address) {
+  std::strncpy(m_peer.address, address, sizeof(m_peer.address) - 1);
+  m_peer.address[sizeof(m_peer.address) - 1] = '\0';
+}
+
+MACAddress LinkSupervisor::peer() const {
+  return m_peer;
+}
+
+void LinkSupervisor::setBackoff(std::uint32_t initialDelay, std::uint32_t maxDelay) {
+  m_initialDelay = initialDelay;
+  m_maxDelay = maxDelay < initialDelay ? initialDelay : maxDelay;
+}
+
+void LinkSupervisor::setConnectTimeout(std::uint32_t timeout) {
+  m_connectTimeout = timeout;
+}
+
+bool LinkSupervisor::poll() {
+  std::uint32_t const now = platformTicks();
+  if (m_module.isConnected()) {
+    if (m_state != State::Connected) {
+      // Central reconnected to us (peripheral role), or the application connected by itself
+      linkRestored(now, false);
+    }
+    return true;
+  }
+
+  if (m_state == State::Connected) {
+    // OK+LOST came between the polls - its time is more accurate than `now`
+    m_state = State::Lost;
+    m_lostTime = m_module.linkLostTime() != 0 ? m_module.linkLostTime() : now;
+    m_lostWhileSupervised = true;
+    m_retryDelay = 0;
+    m_nextAttempt = now;
+    m_statistics.linkLosses++;
+    debugLog("Link lost");
+  } else if (m_state == State::Idle && m_role == Role::Central && m_peer.address[0] != '\0') {
+    m_state = State::Lost;
+    m_nextAttempt = now;
+  }
+
+  if (m_role != Role::Central || m_state != State::Lost || !passed(now, m_nextAttempt)) {
+    return false;
+  }
+  return reconnect();
+}
+
+LinkSupervisor::State LinkSupervisor::state() const {
+  return m_state;
+}
+
+std::uint32_t LinkSupervisor::nextAttemptIn() const {
+  std::uint32_t const now = platformTicks();
+  if (m_role != Role::Central || m_state != State::Lost || passed(now, m_nextAttempt)) {
+    return 0;
+  }
+  return m_nextAttempt - now;
+}
+
+SupervisorStatistics LinkSupervisor::statistics() const {
+  CriticalSection const criticalSection { };
+  return m_statistics;
+}
+
+void LinkSupervisor::resetStatistics() {
+  CriticalSection const criticalSection { };
+  m_statistics = SupervisorStatistics { };
+}
+
+bool LinkSupervisor::reconnect() {
+  // Fast path - the module knows the last address, no scan and no MAC needed
+  m_statistics.reconnectAttempts++;
+  if (m_module.connectLast(m_connectTimeout)) {
+    linkRestored(platformTicks(), true);
+    return true;
+  }
+
+  // Module may have forgotten the address (AT+CLEAR, factory reset), the cached one is still good
+  if (m_peer.address[0] != '\0' && m_module.connect(m_peer.address, m_connectTimeout)) {
+    linkRestored(platformTicks(), false);
+    return true;
+  }
+
+  m_statistics.failedAttempts++;
+  m_retryDelay = (m_retryDelay == 0) ? m_initialDelay : m_retryDelay * 2;
+  m_retryDelay = m_retryDelay > m_maxDelay ? m_maxDelay : m_retryDelay;
+  m_nextAttempt = platformTicks() + m_retryDelay;
+  debugLog("Reconnection failed, next attempt in %lu ms", static_cast<unsigned long>(m_retryDelay));
+  return false;
+}
+
+void LinkSupervisor::linkRestored(std::uint32_t now, bool fast) {
+  m_state = State::Connected;
+  MACAddress const connected = m_module.masterMAC();
+  if (connected.address[0] != '\0') {
+    m_peer = connected;
+  }
+
+  if (!m_lostWhileSupervised) {
+    return;
+  }
+  m_lostWhileSupervised = false;
+
+  std::uint32_t const latency = now - m_lostTime;
+  m_statistics.reconnects++;
+  m_statistics.fastReconnects += fast ? 1 : 0;
+  m_statistics.lastReconnectLatency = latency;
+  m_statistics.totalReconnectLatency += latency;
+  if (latency > m_statistics.maxReconnectLatency) {
+    m_statistics.maxReconnectLatency = latency;
+  }
+}
+
+}
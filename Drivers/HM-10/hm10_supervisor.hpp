@@ -0,0 +1,110 @@
+/*
+ * hm10_supervisor.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Link supervisor - watches the connection and gets it back as fast as possible after it's lost.
+ * Call `poll()` periodically from the thread that owns the HM10 object:
+ *
+ *   HM10::LinkSupervisor supervisor(hm10, HM10::Role::Central);
+ *   for (;;) {
+ *     if (supervisor.poll()) {
+ *       // connected, do the work
+ *     }
+ *     osDelay(10);
+ *   }
+ *
+ * In central role, the supervisor reconnects to the last peer without a discovery scan - first with AT+CONNL
+ * (the module remembers the address of the last connection), then with AT+CON and the MAC address cached
+ * from the last connection (or set with `setPeer`). Failed attempts are retried with exponential backoff.
+ * The module must be in manual mode (see `HM10::setAutomaticMode`), like for `HM10::connect`.
+ * In peripheral role the module goes back to advertising by itself after OK+LOST and the central has to
+ * reconnect, so the supervisor only counts the losses and measures the time it took.
+ *
+ * Reconnect latency is measured from OK+LOST to the moment `poll()` sees the connection, so it includes
+ * the backoff waits and the `poll()` period.
+ */
+
+#pragma once
+#include "hm10.hpp"
+
+namespace HM10 {
+
+// All times are in ms (RTOS ticks)
+struct SupervisorStatistics {
+  std::uint32_t linkLosses { 0 };
+  std::uint32_t reconnects { 0 };
+  // Reconnects done with AT+CONNL
+  std::uint32_t fastReconnects { 0 };
+  std::uint32_t reconnectAttempts { 0 };
+  std::uint32_t failedAttempts { 0 };
+  std::uint32_t lastReconnectLatency { 0 };
+  std::uint32_t maxReconnectLatency { 0 };
+  std::uint32_t totalReconnectLatency { 0 };
+
+  std::uint32_t averageReconnectLatency() const {
+    return reconnects > 0 ? totalReconnectLatency / reconnects : 0;
+  }
+};
+
+class LinkSupervisor {
+public:
+  enum class State : std::uint8_t {
+    // Never connected, and there's no peer to connect to
+    Idle,
+    Connected,
+    // Waiting for the next attempt (central) or for the central to reconnect (peripheral)
+    Lost
+  };
+
+  LinkSupervisor(HM10& module, Role role);
+
+  // MAC address (12 hex characters) to reconnect to when AT+CONNL fails. It's also updated on every connection.
+  // With the peer set, the central connects to it even if it was never connected before.
+  void setPeer(char const* address);
+  MACAddress peer() const;
+
+  // Delay after the first failed attempt, doubled after every next one, up to `maxDelay`.
+  // The first attempt after the link is lost is made right away.
+  void setBackoff(std::uint32_t initialDelay, std::uint32_t maxDelay);
+  // Timeout of a single connection attempt
+  void setConnectTimeout(std::uint32_t timeout);
+
+  // Checks the link and, in central role, reconnects when it's time to. Blocks for the connection attempts
+  // (up to two connect timeouts). Returns `true` if the module is connected.
+  bool poll();
+
+  State state() const;
+  // Time until the next reconnection attempt, 0 if it's due (or there's nothing to do)
+  std::uint32_t nextAttemptIn() const;
+
+  // Statistics are updated only by `poll()`, but they can be read from any task
+  SupervisorStatistics statistics() const;
+  void resetStatistics();
+
+private:
+  bool reconnect();
+  void linkRestored(std::uint32_t now, bool fast);
+
+  HM10& m_module;
+  Role m_role;
+  State m_state { State::Idle };
+  MACAddress m_peer { };
+
+  std::uint32_t m_initialDelay { 100 };
+  std::uint32_t m_maxDelay { 10000 };
+  std::uint32_t m_connectTimeout { 5000 };
+
+  std::uint32_t m_retryDelay { 0 };
+  std::uint32_t m_nextAttempt { 0 };
+  std::uint32_t m_lostTime { 0 };
+  // Latency is measured only for the connections that were lost while supervised
+  bool m_lostWhileSupervised { false };
+
+  SupervisorStatistics m_statistics { };
+};
+
+}
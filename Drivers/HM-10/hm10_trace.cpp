@@ -0,0 +1,66 @@
+/*
+ * hm10_trace.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_trace.hpp"
+
+namespace HM10 {
+namespace Trace {
+
+namespace {
+
+// Free-running indexes, buffer position is index & Mask. Both are modified only with interrupts masked.
+constexpr std::uint32_t Mask { HM10_TRACE_BUFFER_SIZE - 1 };
+std::uint8_t buffer[HM10_TRACE_BUFFER_SIZE] { };
+std::uint32_t head { 0 };
+std::uint32_t tail { 0 };
+std::uint32_t dropped { 0 };
+
+}
+
+void commit(std::uint8_t const* record, std::size_t length) {
+  CriticalSection const criticalSection { };
+  if (HM10_TRACE_BUFFER_SIZE - (head - tail) < length) {
+    dropped++;
+    return;
+  }
+
+  for (std::size_t i = 0; i < length; i++) {
+    buffer[(head + i) & Mask] = record[i];
+  }
+  head += length;
+}
+
+std::size_t read(std::uint8_t* destination, std::size_t maxLength) {
+  std::size_t copied { 0 };
+  while (true) {
+    // One record at a time, so the interrupts are never masked for long
+    CriticalSection const criticalSection { };
+    if (head == tail) {
+      break;
+    }
+
+    std::size_t const length = buffer[tail & Mask];
+    if (copied + length > maxLength) {
+      break;
+    }
+
+    for (std::size_t i = 0; i < length; i++) {
+      destination[copied + i] = buffer[(tail + i) & Mask];
+    }
+    tail += length;
+    copied += length;
+  }
+  return copied;
+}
+
+std::uint32_t droppedRecords() {
+  CriticalSection const criticalSection { };
+  return dropped;
+}
+
+}
+}
@@ -0,0 +1,187 @@
+/*
+ * hm10_trace.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Binary deferred trace - the backend of debugLog/debugLogLL (unless HM10_DEBUG_PRINTF is defined).
+ *
+ * Format strings are never formatted on the MCU. Each one is put in `hm10_trace` section, and
+ * the record stores only its offset in that section (the ID), a cycle counter timestamp and raw arguments.
+ * It takes a few dozen cycles, so it's safe to use in ISRs and can be left enabled in production.
+ *
+ * On the MCU the section is not loaded (INFO in the linker script), so the strings don't take any flash.
+ * Take them from the ELF file, and decode the trace on the PC with Host/Tools/hm10_trace_decode:
+ *   arm-none-eabi-objcopy --dump-section hm10_trace=strings.bin firmware.elf
+ *   hm10_trace_decode strings.bin trace.bin
+ * Trace data is read from the ring buffer with `Trace::read`, or dumped from RAM by the debugger.
+ *
+ * Record layout (little endian):
+ *   u8 record length, u16 format ID, u32 timestamp, arguments
+ * Each argument starts with a tag: 0 - u32, 1 - u64, 2 - string (u8 length and characters, no terminator).
+ */
+
+#pragma once
+#include "hm10_platform.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Size of the trace ring buffer, must be a power of 2
+#ifndef HM10_TRACE_BUFFER_SIZE
+#define HM10_TRACE_BUFFER_SIZE 1024
+#endif
+
+// Longer string arguments are truncated
+#ifndef HM10_TRACE_MAX_STRING
+#define HM10_TRACE_MAX_STRING 24
+#endif
+
+extern "C" char const __start_hm10_trace[];
+
+namespace HM10 {
+namespace Trace {
+
+static_assert((HM10_TRACE_BUFFER_SIZE & (HM10_TRACE_BUFFER_SIZE - 1)) == 0, "HM10_TRACE_BUFFER_SIZE must be a power of 2");
+
+constexpr std::size_t HeaderSize { 7 };
+constexpr std::size_t MaxRecordSize { 64 };
+
+enum class ArgumentTag : std::uint8_t {
+  Word = 0,
+  DoubleWord = 1,
+  String = 2
+};
+
+class Record {
+public:
+  Record(char const* format)
+      : m_length(HeaderSize) {
+    std::uint16_t const id = static_cast<std::uint16_t>(format - __start_hm10_trace);
+    std::uint32_t const timestamp = cycleCounter();
+    m_data[1] = static_cast<std::uint8_t>(id);
+    m_data[2] = static_cast<std::uint8_t>(id >> 8);
+    std::memcpy(&m_data[3], &timestamp, sizeof(timestamp));
+  }
+
+  void add(char const* string) {
+    std::size_t length { 0 };
+    while (string != nullptr && length < HM10_TRACE_MAX_STRING && string[length] != '\0') {
+      length++;
+    }
+    if (m_length + 2 > MaxRecordSize) {
+      return;
+    }
+    if (m_length + 2 + length > MaxRecordSize) {
+      length = MaxRecordSize - m_length - 2;
+    }
+    m_data[m_length++] = static_cast<std::uint8_t>(ArgumentTag::String);
+    m_data[m_length++] = static_cast<std::uint8_t>(length);
+    std::memcpy(&m_data[m_length], string, length);
+    m_length += length;
+  }
+
+  void add(char* string) {
+    add(static_cast<char const*>(string));
+  }
+
+  template <typename T>
+  void add(T value) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+                  "Only integers, enums, pointers and strings can be traced");
+    addValue(value, std::is_pointer<T> { });
+  }
+
+  std::uint8_t const* data() {
+    m_data[0] = static_cast<std::uint8_t>(m_length);
+    return &m_data[0];
+  }
+
+  std::size_t length() const {
+    return m_length;
+  }
+
+private:
+  // Tag dispatch instead of `if constexpr` - the firmware is built with the compiler's default standard (C++14)
+  template <typename T>
+  void addValue(T value, std::true_type /* pointer */) {
+    addNumber(reinterpret_cast<std::uintptr_t>(value));
+  }
+
+  template <typename T>
+  void addValue(T value, std::false_type /* pointer */) {
+    addNumber(value);
+  }
+
+  template <typename T>
+  void addNumber(T value) {
+    addNumber(value, std::integral_constant<bool, (sizeof(T) <= sizeof(std::uint32_t))> { });
+  }
+
+  template <typename T>
+  void addNumber(T value, std::true_type /* fits in a word */) {
+    // Signed values are stored as 32-bit two's complement, the decoder knows the signedness from the format
+    append(ArgumentTag::Word, static_cast<std::uint32_t>(value));
+  }
+
+  template <typename T>
+  void addNumber(T value, std::false_type /* fits in a word */) {
+    append(ArgumentTag::DoubleWord, static_cast<std::uint64_t>(value));
+  }
+
+  template <typename T>
+  void append(ArgumentTag tag, T value) {
+    if (m_length + 1 + sizeof(T) > MaxRecordSize) {
+      return;
+    }
+    m_data[m_length++] = static_cast<std::uint8_t>(tag);
+    std::memcpy(&m_data[m_length], &value, sizeof(T));
+    m_length += sizeof(T);
+  }
+
+  std::uint8_t m_data[MaxRecordSize];
+  std::size_t m_length;
+};
+
+// Puts the record in the ring buffer. If there's not enough space, the record is dropped.
+void commit(std::uint8_t const* record, std::size_t length);
+
+// Copies whole records from the ring buffer to `destination`, returns the amount of bytes copied.
+// Call it from a task, for example to send the trace over a debug UART or save it.
+std::size_t read(std::uint8_t* destination, std::size_t maxLength);
+
+// Amount of records dropped because the buffer was full
+std::uint32_t droppedRecords();
+
+inline void addAll(Record&) {
+}
+
+template <typename T, typename... Args>
+void addAll(Record& record, T value, Args... args) {
+  record.add(value);
+  addAll(record, args...);
+}
+
+template <typename... Args>
+void write(char const* format, Args... args) {
+  Record record { format };
+  addAll(record, args...);
+  commit(record.data(), record.length());
+}
+
+}
+}
+
+#define HM10_TRACE_STRINGIFY(x) #x
+#define HM10_TRACE_TOSTRING(x) HM10_TRACE_STRINGIFY(x)
+#define HM10_TRACE_LINE HM10_TRACE_TOSTRING(__LINE__)
+
+// Format string is a static array in the trace section, its address is the trace ID
+#define HM10_TRACE(format, ...)                                                                      \
+  do {                                                                                               \
+    static char const hm10TraceFormat[] __attribute__((section("hm10_trace"), used)) = format;       \
+    ::HM10::Trace::write(hm10TraceFormat, ## __VA_ARGS__);                                           \
+  } while (false)
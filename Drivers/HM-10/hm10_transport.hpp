@@ -0,0 +1,216 @@
+/*
+ * hm10_transport.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * UART/DMA transport policies - everything the driver needs from the hardware, in one place.
+ * The policy is picked at compile time with HM10_TRANSPORT (and HM10_TRANSPORT_HEADER for out-of-tree ones),
+ * the driver only calls its static functions, so they're inlined - no virtual calls, no function pointers.
+ *
+ *   HALTransport      - HAL UART DMA functions (default)
+ *   RegisterTransport - USART and DMA stream registers directly, HAL handles are only used as the descriptors
+ *                       (Instance pointers). Build with -DHM10_TRANSPORT=RegisterTransport
+ *   Host::MockTransport (Host/Inc/host_mock_transport.hpp) - no UART at all, for the host harnesses
+ *
+ * A transport is a struct with these static functions, `uart` is the handle passed to the HM10 constructor:
+ *   int startReception(UART_HandleTypeDef* uart, std::uint8_t* buffer, std::size_t size)
+ *       enable idle line interrupt and start circular RX DMA into `buffer`, HAL_OK on success
+ *   int restartReception(UART_HandleTypeDef* uart, std::uint8_t* buffer, std::size_t size)
+ *       clear the receive error flags and start the reception again, after an error stopped it
+ *   bool receptionStopped(UART_HandleTypeDef* uart)
+ *   std::size_t receiveCounter(UART_HandleTypeDef* uart) - bytes left to the end of the buffer (DMA counter)
+ *   int startTransmission(UART_HandleTypeDef* uart, std::uint8_t const* data, std::size_t length)
+ *       start TX DMA, HAL_OK on success. `HM10::transmitCompleted()` must be called when it's done
+ *   std::uint32_t errorCode(UART_HandleTypeDef* uart) - HAL_UART_ERROR_* bits of the last error
+ *   void setBaudrate(UART_HandleTypeDef* uart, std::uint32_t baudrate)
+ *   void setIdleLineInterrupt(UART_HandleTypeDef* uart, bool enabled)
+ */
+
+#pragma once
+#include <stm32f4xx.h>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef HM10_TRANSPORT_HEADER
+#include HM10_TRANSPORT_HEADER
+#endif
+
+#ifndef HM10_TRANSPORT
+#define HM10_TRANSPORT HALTransport
+#endif
+
+namespace HM10 {
+
+struct HALTransport {
+  static int startReception(UART_HandleTypeDef* uart, std::uint8_t* buffer, std::size_t size) {
+    __HAL_UART_ENABLE_IT(uart, UART_IT_IDLE);
+    return HAL_UART_Receive_DMA(uart, buffer, size);
+  }
+
+  static int restartReception(UART_HandleTypeDef* uart, std::uint8_t* buffer, std::size_t size) {
+    // Reading SR and DR clears the error flags, so the next byte doesn't raise the error again
+    __HAL_UART_CLEAR_PEFLAG(uart);
+    return HAL_UART_Receive_DMA(uart, buffer, size);
+  }
+
+  // In DMA mode HAL treats every RX error (overrun, framing, noise, parity) as blocking - RX DMA is aborted
+  // before the error callback. TX DMA errors leave the reception running.
+  static bool receptionStopped(UART_HandleTypeDef* uart) {
+    return uart->RxState != HAL_UART_STATE_BUSY_RX;
+  }
+
+  static std::size_t receiveCounter(UART_HandleTypeDef* uart) {
+    return __HAL_DMA_GET_COUNTER(uart->hdmarx);
+  }
+
+  static int startTransmission(UART_HandleTypeDef* uart, std::uint8_t const* data, std::size_t length) {
+    return HAL_UART_Transmit_DMA(uart, const_cast<std::uint8_t*>(data), length);
+  }
+
+  static std::uint32_t errorCode(UART_HandleTypeDef* uart) {
+    return uart->ErrorCode;
+  }
+
+  static void setBaudrate(UART_HandleTypeDef* uart, std::uint32_t baudrate) {
+    uart->Init.BaudRate = baudrate;
+    HAL_UART_Init(uart);
+  }
+
+  static void setIdleLineInterrupt(UART_HandleTypeDef* uart, bool enabled) {
+    if (enabled) {
+      __HAL_UART_ENABLE_IT(uart, UART_IT_IDLE);
+    } else {
+      __HAL_UART_DISABLE_IT(uart, UART_IT_IDLE);
+    }
+  }
+};
+
+#ifndef HM10_HOST_BUILD
+// STM32F4 USART + DMA stream registers. Channel, direction, priority and data sizes of the streams are still
+// configured by CubeMX (HAL_DMA_Init), this only starts and stops the transfers.
+// TX completion is reported with USART TC interrupt (not DMA stream interrupt), and the receive errors are
+// expected in `uart->ErrorCode` - both work with HAL_UART_IRQHandler in USARTx_IRQHandler, or without it,
+// when the interrupt handler reads SR and calls the driver directly.
+struct RegisterTransport {
+  static int startReception(UART_HandleTypeDef* uart, std::uint8_t* buffer, std::size_t size) {
+    USART_TypeDef* const usart = uart->Instance;
+    DMA_Stream_TypeDef* const stream = uart->hdmarx->Instance;
+    if (!stopStream(stream)) {
+      return HAL_TIMEOUT;
+    }
+
+    stream->PAR = address(&usart->DR);
+    stream->M0AR = address(buffer);
+    stream->NDTR = size;
+    stream->CR |= DMA_SxCR_CIRC | DMA_SxCR_EN;
+    uart->ErrorCode = HAL_UART_ERROR_NONE;
+    usart->CR3 |= USART_CR3_DMAR | USART_CR3_EIE;
+    usart->CR1 |= USART_CR1_IDLEIE | USART_CR1_PEIE;
+    return HAL_OK;
+  }
+
+  static int restartReception(UART_HandleTypeDef* uart, std::uint8_t* buffer, std::size_t size) {
+    // SR read followed by DR read clears PE, FE, NE and ORE
+    static_cast<void>(uart->Instance->SR);
+    static_cast<void>(uart->Instance->DR);
+    return startReception(uart, buffer, size);
+  }
+
+  static bool receptionStopped(UART_HandleTypeDef* uart) {
+    return (uart->Instance->CR3 & USART_CR3_DMAR) == 0 || (uart->hdmarx->Instance->CR & DMA_SxCR_EN) == 0;
+  }
+
+  static std::size_t receiveCounter(UART_HandleTypeDef* uart) {
+    return uart->hdmarx->Instance->NDTR;
+  }
+
+  static int startTransmission(UART_HandleTypeDef* uart, std::uint8_t const* data, std::size_t length) {
+    USART_TypeDef* const usart = uart->Instance;
+    DMA_Stream_TypeDef* const stream = uart->hdmatx->Instance;
+    if ((stream->CR & DMA_SxCR_EN) != 0) {
+      return HAL_BUSY;
+    }
+    if (data == nullptr || length == 0) {
+      return HAL_ERROR;
+    }
+
+    clearStreamFlags(stream);
+    stream->CR &= ~StreamInterrupts;
+    stream->PAR = address(&usart->DR);
+    stream->M0AR = address(data);
+    stream->NDTR = length;
+    // TC is cleared by writing 0, other flags ignore it
+    usart->SR = static_cast<std::uint32_t>(~USART_SR_TC);
+    stream->CR |= DMA_SxCR_EN;
+    usart->CR3 |= USART_CR3_DMAT;
+    usart->CR1 |= USART_CR1_TCIE;
+    return HAL_OK;
+  }
+
+  static std::uint32_t errorCode(UART_HandleTypeDef* uart) {
+    return uart->ErrorCode;
+  }
+
+  static void setBaudrate(UART_HandleTypeDef* uart, std::uint32_t baudrate) {
+    USART_TypeDef* const usart = uart->Instance;
+    std::uint32_t const clock = (usart == USART1 || usart == USART6) ? HAL_RCC_GetPCLK2Freq()
+                                                                     : HAL_RCC_GetPCLK1Freq();
+    usart->CR1 &= ~USART_CR1_UE;
+    usart->BRR = (usart->CR1 & USART_CR1_OVER8) != 0 ? UART_BRR_SAMPLING8(clock, baudrate)
+                                                     : UART_BRR_SAMPLING16(clock, baudrate);
+    usart->CR1 |= USART_CR1_UE;
+    uart->Init.BaudRate = baudrate;
+  }
+
+  static void setIdleLineInterrupt(UART_HandleTypeDef* uart, bool enabled) {
+    if (enabled) {
+      uart->Instance->CR1 |= USART_CR1_IDLEIE;
+    } else {
+      uart->Instance->CR1 &= ~USART_CR1_IDLEIE;
+    }
+  }
+
+private:
+  // Stream interrupts are left to HAL DMA handler otherwise, with callbacks of a transfer it didn't start
+  static constexpr std::uint32_t StreamInterrupts { DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE };
+
+  template <typename T>
+  static std::uint32_t address(T* pointer) {
+    return static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(pointer));
+  }
+
+  static bool stopStream(DMA_Stream_TypeDef* stream) {
+    stream->CR &= ~(DMA_SxCR_EN | StreamInterrupts);
+    // EN reads 1 until the current transfer (single data item) is finished
+    for (std::uint32_t i = 0; i < 1000; i++) {
+      if ((stream->CR & DMA_SxCR_EN) == 0) {
+        clearStreamFlags(stream);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Stream flags must be cleared before it's enabled again. Streams are 0x18 bytes apart starting at 0x10
+  // in the controller; 0-3 are cleared in LIFCR, 4-7 in HIFCR, at bit offsets 0, 6, 16 and 22.
+  static void clearStreamFlags(DMA_Stream_TypeDef* stream) {
+    constexpr std::uint32_t FlagOffsets[] = { 0, 6, 16, 22 };
+    std::uintptr_t const address = reinterpret_cast<std::uintptr_t>(stream);
+    DMA_TypeDef* const dma = reinterpret_cast<DMA_TypeDef*>(address & ~std::uintptr_t { 0x3FF });
+    std::size_t const index = ((address & 0x3FF) - 0x10) / 0x18;
+    std::uint32_t const flags = 0x3DU << FlagOffsets[index & 3];
+    if (index < 4) {
+      dma->LIFCR = flags;
+    } else {
+      dma->HIFCR = flags;
+    }
+  }
+};
+#endif
+
+using Transport = HM10_TRANSPORT;
+
+}
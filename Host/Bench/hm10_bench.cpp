@@ -0,0 +1,232 @@
+/*
+ * hm10_bench.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Microbenchmarks of the driver hot paths, on the host.
+ * There's no emulator here - DMA counter is set directly, and the transmissions complete immediately,
+ * so only the driver code is measured (plus the shim overhead for printf, which goes through HAL_UART_Transmit_DMA).
+ *
+ * Usage: hm10_bench [filter] - runs only the benchmarks with `filter` in the name.
+ */
+
+#include <hm10.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+USART_TypeDef usart1 { };
+DMA_Stream_TypeDef dmaRxStream { };
+DMA_HandleTypeDef hdmaRx { &dmaRxStream };
+UART_HandleTypeDef huart1 { &usart1, { 115200, 0, 0, 0, 0, 0, 0 }, nullptr, 0, nullptr, 0, nullptr, &hdmaRx,
+                            HAL_UART_STATE_READY, HAL_UART_STATE_READY, 0 };
+
+HM10::HM10 hm10(&huart1);
+
+extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+  if (huart == &huart1) {
+    hm10.transmitCompleted();
+  }
+}
+
+namespace {
+
+volatile std::size_t sink { 0 };
+
+void dataCallback(char* data, std::size_t length) {
+  sink = sink + length + static_cast<std::size_t>(data[0]);
+}
+
+void connectedCallback(HM10::MACAddress const& mac) {
+  sink = sink + static_cast<std::size_t>(mac.address[0]);
+}
+
+void disconnectedCallback() {
+  sink = sink + 1;
+}
+
+}
+
+namespace HM10 {
+
+struct HostAccess {
+  static void fillRxBuffer(HM10& module, char const* pattern) {
+    std::size_t const patternLength = std::strlen(pattern);
+    for (std::size_t i = 0; i < HM10_BUFFER_SIZE; i++) {
+      module.m_rxBuffer[i] = pattern[i % patternLength];
+    }
+  }
+
+  // Sets the message start, and the DMA counter so that the message has `length` bytes
+  static void setMessage(HM10& module, std::size_t start, std::size_t length) {
+    module.m_msgStartPtr = &module.m_rxBuffer[start];
+    module.UART()->hdmarx->Instance->NDTR = HM10_BUFFER_SIZE - ((start + length) % HM10_BUFFER_SIZE);
+  }
+
+  static void setResponse(HM10& module, char const* response) {
+    std::strcpy(module.m_messageBuffer, response);
+    module.m_messageLength = std::strlen(response);
+  }
+
+  static void startReceiving(HM10& module) {
+    module.startReceivingToBuffer();
+  }
+
+  static bool handleConnectionMessage(HM10& module) {
+    return module.handleConnectionMessage(true);
+  }
+
+  static void copyCommandToBuffer(HM10& module, char const* pattern, char const* argument) {
+    module.copyCommandToBuffer(pattern, argument);
+  }
+
+  static void copyCommandToBuffer(HM10& module, char const* pattern, int argument) {
+    module.copyCommandToBuffer(pattern, argument);
+  }
+
+  static long extractNumberFromResponse(HM10& module, std::size_t offset, int base) {
+    return module.extractNumberFromResponse(offset, base);
+  }
+
+  static void copyStringFromResponse(HM10& module, std::size_t offset, char* destination, std::size_t size) {
+    module.copyStringFromResponse(offset, destination, size);
+  }
+};
+
+}
+
+namespace {
+
+using HM10::HostAccess;
+
+struct Benchmark {
+  char const* name;
+  // Bytes processed by a single operation, 0 if throughput doesn't make sense
+  std::size_t bytesPerOperation;
+  void (*setup)();
+  void (*operation)(std::size_t iteration);
+};
+
+constexpr std::size_t MessageLength { 20 };
+constexpr std::size_t WrappedMessagePrefix { 8 };
+
+Benchmark const Benchmarks[] = {
+  { "receiveCompleted/linear", MessageLength, []() {
+    HostAccess::fillRxBuffer(hm10, "data from the central device ");
+  }, [](std::size_t) {
+    HostAccess::setMessage(hm10, 0, MessageLength);
+    hm10.receiveCompleted();
+  } },
+  { "receiveCompleted/wrapped", MessageLength, []() {
+    HostAccess::fillRxBuffer(hm10, "data from the central device ");
+  }, [](std::size_t) {
+    HostAccess::setMessage(hm10, HM10_BUFFER_SIZE - WrappedMessagePrefix, MessageLength);
+    hm10.receiveCompleted();
+  } },
+  { "receiveCompleted/response", 8, []() {
+    HostAccess::fillRxBuffer(hm10, "OK+Set:1");
+  }, [](std::size_t) {
+    // Response to the command - no callback dispatch
+    HostAccess::startReceiving(hm10);
+    HostAccess::setMessage(hm10, 0, 8);
+    hm10.receiveCompleted();
+  } },
+  { "handleConnectionMessage/conn+lost", 0, nullptr, [](std::size_t iteration) {
+    HostAccess::setResponse(hm10, (iteration & 1) ? "OK+LOST" : "OK+CONN:001122334455");
+    HostAccess::handleConnectionMessage(hm10);
+  } },
+  { "handleConnectionMessage/data", 0, []() {
+    HostAccess::setResponse(hm10, "some application data");
+  }, [](std::size_t) {
+    HostAccess::handleConnectionMessage(hm10);
+  } },
+  { "copyCommandToBuffer/string", 0, nullptr, [](std::size_t) {
+    HostAccess::copyCommandToBuffer(hm10, "AT+NAME%s", "hm10test");
+  } },
+  { "copyCommandToBuffer/number", 0, nullptr, [](std::size_t iteration) {
+    HostAccess::copyCommandToBuffer(hm10, "AT+PASS%06d", static_cast<int>(iteration % 999999));
+  } },
+  { "extractNumberFromResponse/dec", 0, []() {
+    HostAccess::setResponse(hm10, "OK+Get:123456");
+  }, [](std::size_t) {
+    sink = sink + static_cast<std::size_t>(HostAccess::extractNumberFromResponse(hm10, 7, 10));
+  } },
+  { "extractNumberFromResponse/hex", 0, []() {
+    HostAccess::setResponse(hm10, "OK+Get:0xBEEF");
+  }, [](std::size_t) {
+    sink = sink + static_cast<std::size_t>(HostAccess::extractNumberFromResponse(hm10, 9, 16));
+  } },
+  { "copyStringFromResponse", 0, []() {
+    HostAccess::setResponse(hm10, "OK+NAME:hm10test");
+  }, [](std::size_t) {
+    HM10::DeviceName name { };
+    HostAccess::copyStringFromResponse(hm10, 8, name.name, sizeof(name.name));
+    sink = sink + static_cast<std::size_t>(name.name[0]);
+  } },
+  { "printf", 16, nullptr, [](std::size_t iteration) {
+    hm10.printf("value: %08d", static_cast<int>(iteration % 100000000));
+  } },
+};
+
+void run(Benchmark const& benchmark) {
+  using Clock = std::chrono::steady_clock;
+  constexpr auto TargetTime = std::chrono::milliseconds(200);
+
+  if (benchmark.setup != nullptr) {
+    benchmark.setup();
+  }
+
+  // Warm up and find the iteration count that takes roughly TargetTime
+  std::size_t iterations { 1000 };
+  Clock::duration elapsed { };
+  while (true) {
+    auto const start = Clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+      benchmark.operation(i);
+    }
+    elapsed = Clock::now() - start;
+    if (elapsed >= TargetTime / 4) {
+      break;
+    }
+    iterations *= 4;
+  }
+
+  double const scale = std::chrono::duration<double>(TargetTime) / std::chrono::duration<double>(elapsed);
+  iterations = static_cast<std::size_t>(iterations * scale) + 1;
+  auto const start = Clock::now();
+  for (std::size_t i = 0; i < iterations; i++) {
+    benchmark.operation(i);
+  }
+  elapsed = Clock::now() - start;
+
+  double const nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+  if (benchmark.bytesPerOperation > 0) {
+    double const megabytesPerSecond = (benchmark.bytesPerOperation * 1e9 / nanoseconds) / 1e6;
+    std::printf("%-36s %10.1f ns/op %10.1f MB/s\n", benchmark.name, nanoseconds, megabytesPerSecond);
+  } else {
+    std::printf("%-36s %10.1f ns/op\n", benchmark.name, nanoseconds);
+  }
+}
+
+}
+
+int main(int argc, char** argv) {
+  char const* const filter = (argc > 1 ? argv[1] : "");
+
+  hm10.setDataCallback(dataCallback);
+  hm10.setDeviceConnectedCallback(connectedCallback);
+  hm10.setDeviceDisconnectedCallback(disconnectedCallback);
+  hm10.initialize();
+
+  for (Benchmark const& benchmark : Benchmarks) {
+    if (std::strstr(benchmark.name, filter) != nullptr) {
+      run(benchmark);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * fuzz_main.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Standalone driver for the fuzz target, for compilers without libFuzzer.
+ * Usage: hm10_fuzz [-runs=N] [files...]
+ *   With files - runs each of them once (for example, to reproduce a crash found by libFuzzer).
+ *   Without files - runs N (default 100000) random inputs, with fixed seed so the run is reproducible.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(std::uint8_t const* data, std::size_t size);
+
+int main(int argc, char** argv) {
+  unsigned long runs { 100000 };
+  std::vector<char const*> files;
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "-runs=", 6) == 0) {
+      runs = std::strtoul(argv[i] + 6, nullptr, 10);
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+
+  for (char const* path : files) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      std::fprintf(stderr, "Can't open %s\n", path);
+      return 1;
+    }
+    std::vector<std::uint8_t> const data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+    std::printf("%s: OK\n", path);
+  }
+
+  if (!files.empty()) {
+    return 0;
+  }
+
+  std::mt19937 generator { 0x484D3130 };
+  std::uniform_int_distribution<int> byte { 0, 255 };
+  std::uniform_int_distribution<std::size_t> length { 0, 4096 };
+  std::vector<std::uint8_t> data;
+  for (unsigned long run = 0; run < runs; run++) {
+    data.resize(length(generator));
+    for (std::uint8_t& value : data) {
+      value = static_cast<std::uint8_t>(byte(generator));
+    }
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+  }
+  std::printf("%lu random inputs, no errors\n", runs);
+  return 0;
+}
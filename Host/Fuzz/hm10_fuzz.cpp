@@ -0,0 +1,253 @@
+/*
+ * hm10_fuzz.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Fuzz target for the RX path (DMA buffer reconstruction in receiveCompleted) and the response parsers.
+ * The input is a stream of operations: DMA writes, idle line interrupts, raw DMA counter values,
+ * response parsing calls, beacon scan chunks, printf, timer ticks and frame boundary changes. The driver is built with the mock transport
+ * (host_mock_transport.hpp), the fuzzer moves the DMA counter itself. Build it with sanitizers:
+ *   make -C Host fuzz            - g++, ASan + UBSan, runs the standalone driver (fuzz_main.cpp)
+ *   make -C Host fuzz LIBFUZZER=1 - clang++ with libFuzzer
+ */
+
+#include <hm10.hpp>
+#include <hm10_beacon.hpp>
+#include <hm10_transport.hpp>
+#include "host_mock_transport.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+USART_TypeDef usart1 { };
+UART_HandleTypeDef huart1 { &usart1, { 115200, 0, 0, 0, 0, 0, 0 }, nullptr, 0, nullptr, 0, nullptr, nullptr,
+                            HAL_UART_STATE_READY, HAL_UART_STATE_READY, 0 };
+
+namespace {
+
+HM10::HM10* module { nullptr };
+
+// Message has to be fully readable - ASan catches the callback length going past the buffer
+volatile std::uint32_t sink { 0 };
+
+void dataCallback(char* data, std::size_t length) {
+  std::uint32_t sum { 0 };
+  for (std::size_t i = 0; i < length; i++) {
+    sum += static_cast<std::uint8_t>(data[i]);
+  }
+  sink = sink + sum;
+}
+
+void connectedCallback(HM10::MACAddress const& mac) {
+  if (std::strlen(mac.address) >= sizeof(mac.address)) {
+    std::abort();
+  }
+}
+
+void disconnectedCallback() {
+}
+
+}
+
+static_assert(std::is_same<HM10::Transport, Host::MockTransport>::value, "Fuzzer needs the mock transport");
+
+namespace {
+
+// Transmissions complete right away
+void transmitHook(void*, std::uint8_t const*, std::size_t) {
+  if (module != nullptr) {
+    module->transmitCompleted();
+  }
+}
+
+}
+
+namespace HM10 {
+
+struct HostAccess {
+  static void startReceiving(HM10& module) {
+    module.startReceivingToBuffer();
+  }
+
+  static long extractNumberFromResponse(HM10& module, std::size_t offset, int base) {
+    return module.extractNumberFromResponse(offset, base);
+  }
+
+  static void copyStringFromResponse(HM10& module, std::size_t offset, char* destination, std::size_t size) {
+    module.copyStringFromResponse(offset, destination, size);
+  }
+
+  static bool compareWithResponse(HM10& module, char const* string) {
+    return module.compareWithResponse(string);
+  }
+
+  // Message buffer has to stay null-terminated within its size
+  static void checkInvariants(HM10& module) {
+    if (module.m_messageLength >= HM10_BUFFER_SIZE || module.m_messageBuffer[module.m_messageLength] != '\0') {
+      std::abort();
+    }
+    if (module.m_msgStartPtr < module.m_rxBuffer || module.m_msgStartPtr >= module.m_rxBufferEnd) {
+      std::abort();
+    }
+  }
+};
+
+}
+
+namespace {
+
+using HM10::HostAccess;
+
+class Input {
+public:
+  Input(std::uint8_t const* data, std::size_t size)
+      : m_data(data), m_size(size) {
+  }
+
+  bool empty() const {
+    return m_position >= m_size;
+  }
+
+  std::uint8_t byte() {
+    return empty() ? 0 : m_data[m_position++];
+  }
+
+  // Returns up to `length` bytes, less if the input ends
+  std::uint8_t const* bytes(std::size_t& length) {
+    std::size_t const left = m_size - m_position;
+    if (length > left) {
+      length = left;
+    }
+    std::uint8_t const* const result = m_data + m_position;
+    m_position += length;
+    return result;
+  }
+
+private:
+  std::uint8_t const* m_data;
+  std::size_t m_size;
+  std::size_t m_position { 0 };
+};
+
+enum Operation : std::uint8_t {
+  DMAWrite = 0,
+  IdleLine,
+  RawDMACounter,
+  StartReceiving,
+  ParseResponse,
+  ToggleRFComm,
+  BeaconChunk,
+  Printf,
+  TimerTick,
+  SetFrameBoundary,
+  OperationCount
+};
+
+alignas(HM10::HM10) std::uint8_t moduleStorage[sizeof(HM10::HM10)];
+alignas(HM10::BeaconTable) std::uint8_t tableStorage[sizeof(HM10::BeaconTable)];
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(std::uint8_t const* data, std::size_t size) {
+  HM10::HM10& hm10 = *new (moduleStorage) HM10::HM10(&huart1);
+  HM10::BeaconTable& table = *new (tableStorage) HM10::BeaconTable();
+  module = &hm10;
+
+  hm10.setDataCallback(dataCallback);
+  hm10.setDeviceConnectedCallback(connectedCallback);
+  hm10.setDeviceDisconnectedCallback(disconnectedCallback);
+  hm10.initialize();
+
+  Host::MockTransport::State& dma = Host::MockTransport::state();
+  dma.transmitHook = transmitHook;
+  char* const rxBuffer = reinterpret_cast<char*>(dma.rxBuffer);
+  std::size_t dmaPosition { 0 };
+
+  Input input { data, size };
+  while (!input.empty()) {
+    switch (input.byte() % OperationCount) {
+    case DMAWrite: {
+      // Like the circular DMA - wraps around, and can overwrite the data that wasn't processed yet
+      std::size_t length = input.byte();
+      std::uint8_t const* const bytes = input.bytes(length);
+      for (std::size_t i = 0; i < length; i++) {
+        rxBuffer[dmaPosition] = static_cast<char>(bytes[i]);
+        dmaPosition = (dmaPosition + 1) % HM10_BUFFER_SIZE;
+      }
+      dma.rxCounter = HM10_BUFFER_SIZE - dmaPosition;
+      break;
+    }
+    case IdleLine:
+      hm10.idleLineDetected();
+      HostAccess::checkInvariants(hm10);
+      break;
+    case RawDMACounter: {
+      // Garbage counter, for example read during the reload or with misconfigured DMA
+      std::uint32_t const low = input.byte();
+      dma.rxCounter = low | (input.byte() << 8);
+      hm10.receiveCompleted();
+      HostAccess::checkInvariants(hm10);
+      dma.rxCounter = HM10_BUFFER_SIZE - dmaPosition;
+      break;
+    }
+    case StartReceiving:
+      HostAccess::startReceiving(hm10);
+      break;
+    case ParseResponse: {
+      std::size_t const offset = input.byte();
+      char destination[16] { };
+      std::size_t const destinationSize = input.byte() % (sizeof(destination) + 1);
+      sink = sink + static_cast<std::uint32_t>(HostAccess::extractNumberFromResponse(hm10, offset, 10));
+      sink = sink + static_cast<std::uint32_t>(HostAccess::extractNumberFromResponse(hm10, offset, 16));
+      HostAccess::copyStringFromResponse(hm10, offset, destination, destinationSize);
+      if (destinationSize > 0 && std::strlen(destination) >= destinationSize) {
+        std::abort();
+      }
+      sink = sink + HostAccess::compareWithResponse(hm10, "OK+Get:");
+      break;
+    }
+    case ToggleRFComm:
+      hm10.setRFCommMode(!hm10.rfCommMode());
+      break;
+    case BeaconChunk: {
+      std::size_t length = input.byte();
+      std::uint8_t const* const bytes = input.bytes(length);
+      table.ingest(reinterpret_cast<char const*>(bytes), length, 0);
+      break;
+    }
+    case Printf: {
+      char text[HM10_BUFFER_SIZE * 2] { };
+      std::size_t length = input.byte() % sizeof(text);
+      std::uint8_t const* const bytes = input.bytes(length);
+      std::memcpy(text, bytes, length);
+      hm10.printf("%s", text);
+      break;
+    }
+    case TimerTick:
+      hm10.timerTick();
+      HostAccess::checkInvariants(hm10);
+      break;
+    case SetFrameBoundary: {
+      std::uint8_t const boundary = input.byte();
+      hm10.setFrameBoundary(static_cast<HM10::FrameBoundary>(boundary % 3), boundary >> 4);
+      if ((boundary & 0x08) != 0) {
+        hm10.setFrameTerminator((boundary & 0x04) != 0 ? "\r\n" : "\n");
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  module = nullptr;
+  table.~BeaconTable();
+  hm10.~HM10();
+  return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * FreeRTOS.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Host build shim - basic types and the static allocation types, the objects themselves live in the CMSIS-RTOS2
+ * shim (host_rtos.cpp). There are no interrupts on the host, so yielding from them does nothing.
+ */
+
+#pragma once
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t) 0)
+#define pdTRUE ((BaseType_t) 1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFFU)
+#define portYIELD_FROM_ISR(x) ((void) (x))
+
+typedef struct {
+  uint8_t reserved[96];
+} StaticTask_t;
+
+typedef struct {
+  uint8_t reserved[80];
+} StaticQueue_t;
+
+typedef struct {
+  uint8_t reserved[32];
+} StaticEventGroup_t;
+
+typedef struct {
+  uint8_t reserved[40];
+} StaticStreamBuffer_t;
+
+typedef StaticStreamBuffer_t StaticMessageBuffer_t;
@@ -0,0 +1,95 @@
+/*
+ * cmsis_os2.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Host build shim - the subset of CMSIS-RTOS2 API used by the HM-10 driver.
+ * Delays put the calling thread to sleep, tick is 1ms. Threads are std::threads (priorities, stack
+ * and control block memory are ignored), message queues, thread and event flags use mutexes and condition variables.
+ */
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  osOK = 0, osError = -1, osErrorTimeout = -2, osErrorResource = -3, osErrorParameter = -4
+} osStatus_t;
+
+#define osWaitForever 0xFFFFFFFFU
+
+#define osFlagsWaitAny 0x00000000U
+#define osFlagsWaitAll 0x00000001U
+#define osFlagsNoClear 0x00000002U
+
+#define osFlagsError 0x80000000U
+#define osFlagsErrorTimeout 0xFFFFFFFEU
+#define osFlagsErrorParameter 0xFFFFFFFCU
+
+typedef enum {
+  osPriorityNone = 0, osPriorityIdle = 1, osPriorityLow = 8, osPriorityBelowNormal = 16, osPriorityNormal = 24,
+  osPriorityAboveNormal = 32, osPriorityHigh = 40, osPriorityRealtime = 48
+} osPriority_t;
+
+typedef void* osThreadId_t;
+typedef void* osMessageQueueId_t;
+typedef void* osEventFlagsId_t;
+typedef void (*osThreadFunc_t)(void* argument);
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+  void* stack_mem;
+  uint32_t stack_size;
+  osPriority_t priority;
+  uint32_t tz_module;
+  uint32_t reserved;
+} osThreadAttr_t;
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+  void* mq_mem;
+  uint32_t mq_size;
+} osMessageQueueAttr_t;
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+} osEventFlagsAttr_t;
+
+osStatus_t osDelay(uint32_t ticks);
+uint32_t osKernelGetTickCount(void);
+uint32_t osKernelGetTickFreq(void);
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void* argument, const osThreadAttr_t* attr);
+osThreadId_t osThreadGetId(void);
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t* attr);
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void* msg_ptr, uint8_t msg_prio, uint32_t timeout);
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void* msg_ptr, uint8_t* msg_prio, uint32_t timeout);
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id);
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t* attr);
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id);
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
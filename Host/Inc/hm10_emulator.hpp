@@ -0,0 +1,137 @@
+/*
+ * hm10_emulator.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Behavioural HM-10 (firmware V709) emulator for the host build.
+ * It's connected to the simulated UART and answers the AT commands with realistic latencies
+ * (UART transfer time + module processing time), keeps the settings, handles baudrate changes,
+ * reset, sleep/wake up, and simulates the remote side of BLE link (connections and data).
+ *
+ * Everything the emulator sends to the MCU is delivered from its own thread, like an interrupt would.
+ */
+
+#pragma once
+#include "host_uart.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Host {
+
+class HM10Emulator {
+public:
+  struct Peripheral {
+    std::string mac;
+    // Data the peripheral sends after connection
+    std::string pendingData;
+  };
+
+  struct Beacon {
+    std::string uuid; // 32 hex characters
+    std::uint16_t major;
+    std::uint16_t minor;
+    std::int8_t txPower;
+    std::string mac;
+    int rssi;
+  };
+
+  explicit HM10Emulator(UART_HandleTypeDef* uart);
+  ~HM10Emulator();
+
+  HM10Emulator(HM10Emulator const&) = delete;
+  HM10Emulator& operator=(HM10Emulator const&) = delete;
+
+  // Time between receiving the command and starting the response
+  void setResponseLatency(std::chrono::microseconds latency);
+  // Time between AT+RESET response and the module being responsive again
+  void setBootTime(std::chrono::milliseconds bootTime);
+  // Time it takes to establish a connection in central role
+  void setConnectTime(std::chrono::milliseconds connectTime);
+  // Response to AT+VERR?, to emulate older firmware
+  void setFirmwareVersion(std::string const& version);
+
+  // Remote side of the link (module in peripheral role)
+  void connectRemote(std::string const& mac);
+  void disconnectRemote();
+  void sendFromRemote(std::string const& data);
+  // Returns and clears the data the module has sent to the remote device
+  std::string takeRemoteData();
+  // Remote device is an HM-10 in remote control mode (AT+MODE2) - it answers AT+RSSI? sent over the link.
+  // Other remote commands are not emulated.
+  void setRemoteControl(bool enabled);
+
+  // Devices visible to the module in central role
+  void addPeripheral(Peripheral const& peripheral);
+  void addBeacon(Beacon const& beacon);
+
+  // Module state
+  std::string setting(std::string const& name) const;
+  bool isConnected() const;
+  bool isAsleep() const;
+  std::uint32_t baudrate() const;
+  std::size_t commandsProcessed() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static void transmitHook(void* context, std::uint8_t const* data, std::size_t length);
+  void received(std::string const& data);
+  void processCommand(std::string const& command);
+  bool processSpecialCommand(std::string const& command);
+
+  // Schedule the response, it'll be delivered after response latency + transfer time
+  void respond(std::string const& response, std::chrono::microseconds delay = std::chrono::microseconds(0));
+  void schedule(Clock::time_point time, std::function<void()> action);
+  void worker();
+
+  void restoreDefaults();
+  void reboot();
+  void connect(std::string const& mac);
+  void lostConnection();
+
+  UART_HandleTypeDef* m_uart;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::multimap<Clock::time_point, std::function<void()>> m_events;
+  std::thread m_worker;
+  bool m_running { true };
+
+  std::chrono::microseconds m_responseLatency { 8000 };
+  std::chrono::milliseconds m_bootTime { 500 };
+  std::chrono::milliseconds m_connectTime { 300 };
+  std::string m_firmwareVersion { "HMSoft V709" };
+  // Responses are serialized - next one can't start before the previous one has been sent
+  Clock::time_point m_lineFreeTime { };
+
+  std::map<std::string, std::string> m_settings;
+  std::uint8_t m_pendingBaud { 4 };
+  std::uint8_t m_baud { 4 };
+  bool m_booting { false };
+  bool m_asleep { false };
+  std::size_t m_wakeUpCharacters { 0 };
+  // Last received data, for the auto sleep idle time
+  Clock::time_point m_lastActivity { };
+  bool m_connected { false };
+  std::string m_connectedMAC;
+  std::string m_lastConnectedMAC;
+  std::string m_remoteData;
+  bool m_remoteControl { false };
+  std::size_t m_commandsProcessed { 0 };
+
+  std::vector<Peripheral> m_peripherals;
+  std::vector<Beacon> m_beacons;
+};
+
+}
@@ -0,0 +1,96 @@
+/*
+ * host_mock_transport.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Transport policy (see hm10_transport.hpp) without any UART - the harness plays the DMA controller itself:
+ * writes into the RX buffer, moves `rxCounter`, and completes the transmissions in `transmitHook`.
+ * Used by the fuzzer, so the protocol code is exercised without the HAL shim in between:
+ *   -DHM10_TRANSPORT_HEADER='"host_mock_transport.hpp"' -DHM10_TRANSPORT=::Host::MockTransport
+ * There's one state for all UART handles.
+ */
+
+#pragma once
+#include <stm32f4xx.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Host {
+
+struct MockTransport {
+  using TransmitHook = void (*)(void* context, std::uint8_t const* data, std::size_t length);
+
+  struct State {
+    std::uint8_t* rxBuffer { nullptr };
+    std::size_t rxSize { 0 };
+    // Bytes left to the end of the RX buffer, like DMA NDTR
+    std::size_t rxCounter { 0 };
+    bool receiving { false };
+    std::uint32_t errorCode { HAL_UART_ERROR_NONE };
+    std::uint32_t baudrate { 0 };
+    std::uint32_t receptionStarts { 0 };
+    bool idleLineInterrupt { false };
+    // Called from startTransmission, HM10::transmitCompleted() can be called right there.
+    // Without the hook, transmissions never complete.
+    TransmitHook transmitHook { nullptr };
+    void* context { nullptr };
+  };
+
+  static State& state() {
+    static State instance { };
+    return instance;
+  }
+
+  static int startReception(UART_HandleTypeDef*, std::uint8_t* buffer, std::size_t size) {
+    State& mock = state();
+    mock.rxBuffer = buffer;
+    mock.rxSize = size;
+    mock.rxCounter = size;
+    mock.receiving = true;
+    mock.idleLineInterrupt = true;
+    mock.errorCode = HAL_UART_ERROR_NONE;
+    mock.receptionStarts++;
+    return HAL_OK;
+  }
+
+  static int restartReception(UART_HandleTypeDef* uart, std::uint8_t* buffer, std::size_t size) {
+    return startReception(uart, buffer, size);
+  }
+
+  static bool receptionStopped(UART_HandleTypeDef*) {
+    return !state().receiving;
+  }
+
+  static std::size_t receiveCounter(UART_HandleTypeDef*) {
+    return state().rxCounter;
+  }
+
+  static int startTransmission(UART_HandleTypeDef*, std::uint8_t const* data, std::size_t length) {
+    if (data == nullptr || length == 0) {
+      return HAL_ERROR;
+    }
+    State const& mock = state();
+    if (mock.transmitHook != nullptr) {
+      mock.transmitHook(mock.context, data, length);
+    }
+    return HAL_OK;
+  }
+
+  static std::uint32_t errorCode(UART_HandleTypeDef*) {
+    return state().errorCode;
+  }
+
+  static void setBaudrate(UART_HandleTypeDef* uart, std::uint32_t baudrate) {
+    uart->Init.BaudRate = baudrate;
+    state().baudrate = baudrate;
+  }
+
+  static void setIdleLineInterrupt(UART_HandleTypeDef*, bool enabled) {
+    state().idleLineInterrupt = enabled;
+  }
+};
+
+}
@@ -0,0 +1,60 @@
+/*
+ * host_uart.hpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Device side of the simulated UART. The driver talks to the UART through the regular HAL calls
+ * (see stm32f4xx.h shim), while the device on the other end (HM-10 emulator, replay tool, fuzzer)
+ * uses these functions to receive the transmitted data and to put the data into RX DMA buffer.
+ *
+ * Everything that would run in interrupt context on the MCU (idle line handler, TX completion callback)
+ * is called with `interruptLock()` held, so `__disable_irq()` in the driver works as expected.
+ */
+
+#pragma once
+#include <stm32f4xx.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace HostUART {
+
+using TransmitHook = void (*)(void* context, std::uint8_t const* data, std::size_t length);
+using InterruptHandler = void (*)();
+
+// Connects the device to the UART. Every HAL_UART_Transmit_DMA call will pass the data to `hook`,
+// and the device is responsible for calling `completeTransmit` afterwards.
+// Without the device, transmissions are completed immediately.
+void attach(UART_HandleTypeDef* uart, TransmitHook hook, void* context);
+void detach(UART_HandleTypeDef* uart);
+
+// USARTx_IRQHandler equivalent, called after setting the status flags in SR
+void setInterruptHandler(UART_HandleTypeDef* uart, InterruptHandler handler);
+
+// Writes the data into the RX buffer, like circular DMA would, without signalling the idle line
+void write(UART_HandleTypeDef* uart, std::uint8_t const* data, std::size_t length);
+// Sets the idle line flag and calls the interrupt handler
+void signalIdle(UART_HandleTypeDef* uart);
+// write + signalIdle
+void deliver(UART_HandleTypeDef* uart, std::uint8_t const* data, std::size_t length);
+
+// Finishes pending DMA transmission and calls HAL_UART_TxCpltCallback
+void completeTransmit(UART_HandleTypeDef* uart);
+
+// Sets the error code and calls HAL_UART_ErrorCallback. If `stopReception` is true, RX DMA is stopped
+// the same way HAL does it on overrun.
+void raiseError(UART_HandleTypeDef* uart, std::uint32_t errorCode, bool stopReception);
+
+// Time it takes to transfer `bytes` bytes with current UART baudrate, in microseconds
+std::uint32_t transferTime(UART_HandleTypeDef const* uart, std::size_t bytes);
+
+std::recursive_mutex& interruptLock();
+
+// `true` while the interrupt handler or HAL UART callback runs in the calling thread (IPSR != 0 on the MCU).
+// The RTOS shim uses it to catch the task API called from interrupts, and FromISR API called from tasks.
+bool inInterrupt();
+
+}
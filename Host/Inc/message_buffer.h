@@ -0,0 +1,30 @@
+/*
+ * message_buffer.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Host build shim - message buffers are stream buffers in message mode, same as in FreeRTOS.
+ */
+
+#pragma once
+#include "stream_buffer.h"
+
+typedef void* MessageBufferHandle_t;
+
+#define xMessageBufferCreate(xBufferSizeBytes) \
+  ((MessageBufferHandle_t) xStreamBufferGenericCreate(xBufferSizeBytes, 0, pdTRUE))
+#define xMessageBufferCreateStatic(xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer) \
+  ((MessageBufferHandle_t) xStreamBufferGenericCreateStatic(xBufferSizeBytes, 0, pdTRUE, \
+                                                            pucMessageBufferStorageArea, pxStaticMessageBuffer))
+#define xMessageBufferSend(xMessageBuffer, pvTxData, xDataLengthBytes, xTicksToWait) \
+  xStreamBufferSend((StreamBufferHandle_t) (xMessageBuffer), pvTxData, xDataLengthBytes, xTicksToWait)
+#define xMessageBufferSendFromISR(xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken) \
+  xStreamBufferSendFromISR((StreamBufferHandle_t) (xMessageBuffer), pvTxData, xDataLengthBytes, \
+                           pxHigherPriorityTaskWoken)
+#define xMessageBufferReceive(xMessageBuffer, pvRxData, xBufferLengthBytes, xTicksToWait) \
+  xStreamBufferReceive((StreamBufferHandle_t) (xMessageBuffer), pvRxData, xBufferLengthBytes, xTicksToWait)
+#define xMessageBufferSpacesAvailable(xMessageBuffer) \
+  xStreamBufferSpacesAvailable((StreamBufferHandle_t) (xMessageBuffer))
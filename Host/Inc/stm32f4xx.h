@@ -0,0 +1,148 @@
+/*
+ * stm32f4xx.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Host build shim - minimal subset of STM32F4 CMSIS and HAL used by the HM-10 driver.
+ * Types and macros have the same names and meaning as the real ones, so the driver compiles unchanged.
+ * The UART "hardware" is simulated in host_uart.cpp, see host_uart.hpp for the device-side API.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  HAL_OK = 0x00U, HAL_ERROR = 0x01U, HAL_BUSY = 0x02U, HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct {
+  volatile uint32_t SR;
+  volatile uint32_t DR;
+  volatile uint32_t BRR;
+  volatile uint32_t CR1;
+  volatile uint32_t CR2;
+  volatile uint32_t CR3;
+  volatile uint32_t GTPR;
+} USART_TypeDef;
+
+typedef struct {
+  volatile uint32_t CR;
+  volatile uint32_t NDTR;
+  volatile uint32_t PAR;
+  volatile uint32_t M0AR;
+  volatile uint32_t M1AR;
+  volatile uint32_t FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+  DMA_Stream_TypeDef* Instance;
+} DMA_HandleTypeDef;
+
+typedef struct {
+  uint32_t BaudRate;
+  uint32_t WordLength;
+  uint32_t StopBits;
+  uint32_t Parity;
+  uint32_t Mode;
+  uint32_t HwFlowCtl;
+  uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef enum {
+  HAL_UART_STATE_RESET = 0x00U,
+  HAL_UART_STATE_READY = 0x20U,
+  HAL_UART_STATE_BUSY = 0x24U,
+  HAL_UART_STATE_BUSY_TX = 0x21U,
+  HAL_UART_STATE_BUSY_RX = 0x22U,
+  HAL_UART_STATE_ERROR = 0xE0U
+} HAL_UART_StateTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+  USART_TypeDef* Instance;
+  UART_InitTypeDef Init;
+  uint8_t* pTxBuffPtr;
+  uint16_t TxXferSize;
+  uint8_t* pRxBuffPtr;
+  uint16_t RxXferSize;
+  DMA_HandleTypeDef* hdmatx;
+  DMA_HandleTypeDef* hdmarx;
+  volatile HAL_UART_StateTypeDef gState;
+  volatile HAL_UART_StateTypeDef RxState;
+  volatile uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+#define USART_SR_PE     0x00000001U
+#define USART_SR_FE     0x00000002U
+#define USART_SR_NE     0x00000004U
+#define USART_SR_ORE    0x00000008U
+#define USART_SR_IDLE   0x00000010U
+#define USART_SR_RXNE   0x00000020U
+#define USART_SR_TC     0x00000040U
+#define USART_SR_TXE    0x00000080U
+
+#define USART_CR1_IDLEIE  0x00000010U
+#define USART_CR1_RXNEIE  0x00000020U
+#define USART_CR1_TCIE    0x00000040U
+#define USART_CR1_PEIE    0x00000100U
+#define USART_CR3_EIE     0x00000001U
+#define USART_CR3_DMAR    0x00000040U
+#define USART_CR3_DMAT    0x00000080U
+
+#define UART_FLAG_PE    USART_SR_PE
+#define UART_FLAG_FE    USART_SR_FE
+#define UART_FLAG_NE    USART_SR_NE
+#define UART_FLAG_ORE   USART_SR_ORE
+#define UART_FLAG_IDLE  USART_SR_IDLE
+#define UART_FLAG_RXNE  USART_SR_RXNE
+#define UART_FLAG_TC    USART_SR_TC
+#define UART_FLAG_TXE   USART_SR_TXE
+
+#define UART_IT_IDLE    USART_CR1_IDLEIE
+#define UART_IT_TC      USART_CR1_TCIE
+
+#define HAL_UART_ERROR_NONE   0x00000000U
+#define HAL_UART_ERROR_PE     0x00000001U
+#define HAL_UART_ERROR_NE     0x00000002U
+#define HAL_UART_ERROR_FE     0x00000004U
+#define HAL_UART_ERROR_ORE    0x00000008U
+#define HAL_UART_ERROR_DMA    0x00000010U
+
+#define __HAL_UART_ENABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->CR1 |= (__INTERRUPT__))
+#define __HAL_UART_DISABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->CR1 &= ~(__INTERRUPT__))
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__) (((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__))
+#define __HAL_UART_CLEAR_FLAG(__HANDLE__, __FLAG__) ((__HANDLE__)->Instance->SR &= ~(__FLAG__))
+#define __HAL_UART_CLEAR_IDLEFLAG(__HANDLE__) __HAL_UART_CLEAR_FLAG(__HANDLE__, UART_FLAG_IDLE)
+// Real one reads SR and DR, which clears all the receive error flags
+#define __HAL_UART_CLEAR_PEFLAG(__HANDLE__) \
+  __HAL_UART_CLEAR_FLAG(__HANDLE__, UART_FLAG_PE | UART_FLAG_FE | UART_FLAG_NE | UART_FLAG_ORE)
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->NDTR)
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef* huart);
+
+// Implemented by the application, the shim provides empty weak definitions
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+// Interrupt masking - on the host it's a global lock shared with simulated interrupt handlers
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,50 @@
+/*
+ * stream_buffer.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Host build shim - the subset of FreeRTOS stream buffer API used by the HM-10 driver and its example.
+ * Like in FreeRTOS, message buffers are stream buffers with every message prefixed with its length,
+ * so both are implemented by the same functions (in host_rtos.cpp). Trigger level is ignored,
+ * a receiver wakes up on any data.
+ */
+
+#pragma once
+#include <stddef.h>
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct StreamBufferDef_t* StreamBufferHandle_t;
+
+StreamBufferHandle_t xStreamBufferGenericCreate(size_t xBufferSizeBytes, size_t xTriggerLevelBytes,
+                                                BaseType_t xIsMessageBuffer);
+StreamBufferHandle_t xStreamBufferGenericCreateStatic(size_t xBufferSizeBytes, size_t xTriggerLevelBytes,
+                                                      BaseType_t xIsMessageBuffer,
+                                                      uint8_t* const pucStreamBufferStorageArea,
+                                                      StaticStreamBuffer_t* const pxStaticStreamBuffer);
+
+#define xStreamBufferCreate(xBufferSizeBytes, xTriggerLevelBytes) \
+  xStreamBufferGenericCreate(xBufferSizeBytes, xTriggerLevelBytes, pdFALSE)
+#define xStreamBufferCreateStatic(xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, \
+                                  pxStaticStreamBuffer) \
+  xStreamBufferGenericCreateStatic(xBufferSizeBytes, xTriggerLevelBytes, pdFALSE, pucStreamBufferStorageArea, \
+                                   pxStaticStreamBuffer)
+
+size_t xStreamBufferSend(StreamBufferHandle_t xStreamBuffer, const void* pvTxData, size_t xDataLengthBytes,
+                         TickType_t xTicksToWait);
+size_t xStreamBufferSendFromISR(StreamBufferHandle_t xStreamBuffer, const void* pvTxData, size_t xDataLengthBytes,
+                                BaseType_t* const pxHigherPriorityTaskWoken);
+size_t xStreamBufferReceive(StreamBufferHandle_t xStreamBuffer, void* pvRxData, size_t xBufferLengthBytes,
+                            TickType_t xTicksToWait);
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t xStreamBuffer);
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,31 @@
+/*
+ * timers.h
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Host build shim - the subset of FreeRTOS software timer API used by the HM-10 driver.
+ * Pended functions are called in order by a timer service thread (host_rtos.cpp), with the same queue length
+ * as configTIMER_QUEUE_LENGTH of the example project.
+ */
+
+#pragma once
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*PendedFunction_t)(void*, uint32_t);
+
+BaseType_t xTimerPendFunctionCall(PendedFunction_t xFunctionToPend, void* pvParameter1, uint32_t ulParameter2,
+                                  TickType_t xTicksToWait);
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t xFunctionToPend, void* pvParameter1, uint32_t ulParameter2,
+                                         BaseType_t* pxHigherPriorityTaskWoken);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,476 @@
+/*
+ * hm10_emulator.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "hm10_emulator.hpp"
+
+#include <cstdio>
+
+namespace Host {
+
+namespace {
+
+constexpr std::uint32_t Baudrates[] = { 9600, 19200, 38400, 57600, 115200, 4800, 2400, 1200, 230400 };
+constexpr std::uint8_t DefaultBaud { 4 };
+
+// BLE packets carry up to 20 bytes of data
+constexpr std::size_t RemotePacketSize { 20 };
+constexpr std::chrono::milliseconds RemotePacketInterval { 15 };
+constexpr std::chrono::milliseconds DiscoveryLineInterval { 50 };
+// Module wakes up after receiving more than 80 characters
+constexpr std::size_t WakeUpCharacters { 80 };
+// Idle time after which the module in auto sleep mode (AT+PWRM0) falls asleep. Not documented - it's only
+// above the driver's HM10_AUTO_SLEEP_IDLE_TIME, like it has to be on the real module.
+constexpr std::chrono::milliseconds AutoSleepIdleTime { 200 };
+
+std::string toHex(std::uint32_t value, int digits) {
+  char buffer[16];
+  std::snprintf(buffer, sizeof(buffer), "%0*X", digits, value);
+  return buffer;
+}
+
+}
+
+HM10Emulator::HM10Emulator(UART_HandleTypeDef* uart)
+    : m_uart(uart) {
+  restoreDefaults();
+  m_baud = m_pendingBaud;
+  HostUART::attach(m_uart, &HM10Emulator::transmitHook, this);
+  m_worker = std::thread(&HM10Emulator::worker, this);
+}
+
+HM10Emulator::~HM10Emulator() {
+  HostUART::detach(m_uart);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+  }
+  m_condition.notify_all();
+  m_worker.join();
+}
+
+void HM10Emulator::setResponseLatency(std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_responseLatency = latency;
+}
+
+void HM10Emulator::setBootTime(std::chrono::milliseconds bootTime) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_bootTime = bootTime;
+}
+
+void HM10Emulator::setConnectTime(std::chrono::milliseconds connectTime) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_connectTime = connectTime;
+}
+
+void HM10Emulator::setFirmwareVersion(std::string const& version) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_firmwareVersion = version;
+}
+
+void HM10Emulator::connectRemote(std::string const& mac) {
+  schedule(Clock::now(), [this, mac]() {
+    connect(mac);
+  });
+}
+
+void HM10Emulator::disconnectRemote() {
+  schedule(Clock::now(), [this]() {
+    if (m_connected) {
+      lostConnection();
+    }
+  });
+}
+
+void HM10Emulator::sendFromRemote(std::string const& data) {
+  schedule(Clock::now(), [this, data]() {
+    if (m_connected) {
+      respond(data);
+    }
+  });
+}
+
+void HM10Emulator::setRemoteControl(bool enabled) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_remoteControl = enabled;
+}
+
+std::string HM10Emulator::takeRemoteData() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::string data { };
+  data.swap(m_remoteData);
+  return data;
+}
+
+void HM10Emulator::addPeripheral(Peripheral const& peripheral) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_peripherals.push_back(peripheral);
+}
+
+void HM10Emulator::addBeacon(Beacon const& beacon) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_beacons.push_back(beacon);
+}
+
+std::string HM10Emulator::setting(std::string const& name) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto const it = m_settings.find(name);
+  return (it != m_settings.end() ? it->second : std::string { });
+}
+
+bool HM10Emulator::isConnected() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_connected;
+}
+
+bool HM10Emulator::isAsleep() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_asleep;
+}
+
+std::uint32_t HM10Emulator::baudrate() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return Baudrates[m_baud];
+}
+
+std::size_t HM10Emulator::commandsProcessed() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_commandsProcessed;
+}
+
+void HM10Emulator::transmitHook(void* context, std::uint8_t const* data, std::size_t length) {
+  HM10Emulator* const emulator = static_cast<HM10Emulator*>(context);
+  UART_HandleTypeDef* const uart = emulator->m_uart;
+  auto const arrivalTime = Clock::now() + std::chrono::microseconds(HostUART::transferTime(uart, length));
+
+  // With mismatched baudrates the module receives only garbage
+  bool const baudrateMatches = (uart->Init.BaudRate == emulator->baudrate());
+  std::string const text(reinterpret_cast<char const*>(data), length);
+
+  emulator->schedule(arrivalTime, [emulator, uart, text, baudrateMatches]() {
+    HostUART::completeTransmit(uart);
+    if (baudrateMatches) {
+      emulator->received(text);
+    }
+  });
+}
+
+// Called from the worker thread only, so the module state can be accessed with m_mutex taken for short periods
+void HM10Emulator::received(std::string const& data) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_booting) {
+    return;
+  }
+
+  Clock::time_point const now = Clock::now();
+  if (!m_asleep && !m_connected && m_settings["PWRM"] == "0" && now - m_lastActivity >= AutoSleepIdleTime) {
+    m_asleep = true;
+    m_wakeUpCharacters = 0;
+  }
+  m_lastActivity = now;
+
+  if (m_asleep) {
+    if (m_settings["UART"] == "1") {
+      return;
+    }
+    m_wakeUpCharacters += data.size();
+    if (m_wakeUpCharacters > WakeUpCharacters) {
+      m_asleep = false;
+      m_wakeUpCharacters = 0;
+      lock.unlock();
+      respond("OK+WAKE");
+    }
+    return;
+  }
+
+  // In connected state everything except AT goes to the remote device
+  if (m_connected && data != "AT") {
+    if (m_remoteControl && data == "AT+RSSI?") {
+      std::string const response = "OK+RSSI:-0" + std::to_string(55 + (m_commandsProcessed++ % 20));
+      lock.unlock();
+      respond(response);
+      return;
+    }
+    m_remoteData += data;
+    return;
+  }
+
+  m_commandsProcessed++;
+  lock.unlock();
+  processCommand(data);
+}
+
+void HM10Emulator::processCommand(std::string const& command) {
+  if (command == "AT") {
+    if (m_connected) {
+      lostConnection();
+    } else {
+      respond("OK");
+    }
+    return;
+  }
+
+  if (command.compare(0, 3, "AT+") != 0) {
+    return;
+  }
+
+  std::string const body = command.substr(3);
+  if (processSpecialCommand(body)) {
+    return;
+  }
+
+  if (body.size() < 5) {
+    return;
+  }
+
+  std::string const key = body.substr(0, 4);
+  std::string const argument = body.substr(4);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto const setting = m_settings.find(key);
+  if (setting == m_settings.end()) {
+    return;
+  }
+
+  if (argument == "?") {
+    std::string const value = setting->second;
+    lock.unlock();
+    if (key == "NAME" || key == "ADDR") {
+      respond("OK+" + key + ":" + value);
+    } else {
+      respond("OK+Get:" + value);
+    }
+    return;
+  }
+
+  if (key == "BAUD") {
+    if (argument.size() != 1 || argument[0] < '0' || argument[0] > '8') {
+      return;
+    }
+    // New baudrate is applied after reset
+    m_pendingBaud = static_cast<std::uint8_t>(argument[0] - '0');
+  }
+
+  setting->second = argument;
+  lock.unlock();
+  respond("OK+Set:" + argument);
+}
+
+bool HM10Emulator::processSpecialCommand(std::string const& command) {
+  if (command == "RESET") {
+    respond("OK+RESET");
+    reboot();
+  } else if (command == "RENEW") {
+    respond("OK+RENEW");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    restoreDefaults();
+  } else if (command == "CLEAR") {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_lastConnectedMAC.clear();
+    }
+    respond("OK+CLEAR");
+  } else if (command == "ERASE") {
+    respond("OK+ERASE");
+  } else if (command == "START") {
+    respond("OK+START");
+  } else if (command == "SLEEP") {
+    respond("OK+SLEEP");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_asleep = true;
+    m_wakeUpCharacters = 0;
+  } else if (command == "VERR?" || command == "VERS?") {
+    std::string version { };
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      version = m_firmwareVersion;
+    }
+    respond(version);
+  } else if (command.size() == 5 && command.compare(0, 2, "AD") == 0 && command[2] >= '1' && command[2] <= '3') {
+    if (command.compare(3, 2, "??") == 0) {
+      respond("OK+AD" + command.substr(2, 1) + "?:" + setting("AD" + command.substr(2, 1)));
+    }
+  } else if (command.size() == 15 && command.compare(0, 2, "AD") == 0 && command[2] >= '1' && command[2] <= '3') {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_settings["AD" + command.substr(2, 1)] = command.substr(3);
+    }
+    respond("OK+AD" + command.substr(2, 1) + ":" + command.substr(3));
+  } else if (command == "CONNL" || (command.size() == 15 && command.compare(0, 3, "CON") == 0)) {
+    std::string mac { };
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_settings["ROLE"] != "1") {
+        return true;
+      }
+      mac = (command == "CONNL" ? m_lastConnectedMAC : command.substr(3));
+    }
+    if (command == "CONNL" && mac.empty()) {
+      respond("OK+CONNN");
+      return true;
+    }
+    respond(command == "CONNL" ? "OK+CONNL" : "OK+CONNA");
+
+    bool known { false };
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (Peripheral const& peripheral : m_peripherals) {
+        known = known || peripheral.mac == mac;
+      }
+    }
+    schedule(Clock::now() + m_connectTime, [this, mac, known]() {
+      if (known) {
+        connect(mac);
+      } else {
+        respond("OK+CONNF");
+      }
+    });
+  } else if (command == "DISI?") {
+    std::vector<Beacon> beacons { };
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_settings["ROLE"] != "1") {
+        return true;
+      }
+      beacons = m_beacons;
+    }
+    respond("OK+DISIS");
+    std::chrono::microseconds delay { 0 };
+    for (Beacon const& beacon : beacons) {
+      delay += DiscoveryLineInterval;
+      char rssi[16];
+      std::snprintf(rssi, sizeof(rssi), "-%03d", -beacon.rssi);
+      respond("OK+DISC:4C000215:" + beacon.uuid + ":" + toHex(beacon.major, 4) + toHex(beacon.minor, 4)
+              + toHex(static_cast<std::uint8_t>(beacon.txPower), 2) + ":" + beacon.mac + ":" + rssi,
+              delay);
+    }
+    respond("OK+DISCE", delay + DiscoveryLineInterval);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void HM10Emulator::respond(std::string const& response, std::chrono::microseconds delay) {
+  Clock::time_point deliveryTime { };
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Clock::time_point startTime = Clock::now() + m_responseLatency + delay;
+    if (startTime < m_lineFreeTime) {
+      startTime = m_lineFreeTime;
+    }
+    // + 1 character of idle line
+    deliveryTime = startTime + std::chrono::microseconds(HostUART::transferTime(m_uart, response.size() + 1));
+    m_lineFreeTime = deliveryTime;
+  }
+
+  schedule(deliveryTime, [this, response]() {
+    // With mismatched baudrates the MCU receives only garbage, just drop it
+    if (m_uart->Init.BaudRate == baudrate()) {
+      HostUART::deliver(m_uart, reinterpret_cast<std::uint8_t const*>(response.data()), response.size());
+    }
+  });
+}
+
+void HM10Emulator::schedule(Clock::time_point time, std::function<void()> action) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_events.emplace(time, std::move(action));
+  }
+  m_condition.notify_all();
+}
+
+void HM10Emulator::worker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (m_running) {
+    if (m_events.empty()) {
+      m_condition.wait(lock);
+      continue;
+    }
+
+    auto const next = m_events.begin();
+    if (next->first > Clock::now()) {
+      m_condition.wait_until(lock, next->first);
+      continue;
+    }
+
+    std::function<void()> const action = std::move(next->second);
+    m_events.erase(next);
+    lock.unlock();
+    action();
+    lock.lock();
+  }
+}
+
+void HM10Emulator::restoreDefaults() {
+  m_settings = { { "ADDR", "A4C138000001" }, { "ADVI", "0" }, { "ADTY", "0" }, { "ALLO", "0" },
+                 { "AD1", "000000000000" }, { "AD2", "000000000000" }, { "AD3", "000000000000" },
+                 { "BAUD", "4" }, { "CHAR", "0xFFE1" }, { "COMI", "3" }, { "COMA", "7" }, { "COLA", "0" },
+                 { "COSU", "6" }, { "COUP", "1" }, { "FFE2", "0" }, { "GAIN", "0" }, { "IMME", "0" },
+                 { "MODE", "0" }, { "NAME", "HMSoft" }, { "NOTI", "0" }, { "NOTP", "0" }, { "PACK", "0" },
+                 { "PASS", "000000" }, { "PCTL", "1" }, { "POWE", "2" }, { "PWRM", "1" }, { "RELI", "0" },
+                 { "ROLE", "0" }, { "TYPE", "0" }, { "UART", "0" }, { "UUID", "0xFFE0" } };
+  m_pendingBaud = DefaultBaud;
+  m_lastConnectedMAC.clear();
+}
+
+void HM10Emulator::reboot() {
+  std::chrono::milliseconds bootTime { };
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_booting = true;
+    m_connected = false;
+    bootTime = m_bootTime;
+  }
+
+  // Module stops listening right after sending the response
+  schedule(m_lineFreeTime + bootTime, [this]() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_baud = m_pendingBaud;
+    m_booting = false;
+    m_asleep = false;
+  });
+}
+
+void HM10Emulator::connect(std::string const& mac) {
+  std::string pendingData { };
+  bool notifyAddress { false };
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_connected) {
+      return;
+    }
+    m_connected = true;
+    m_connectedMAC = mac;
+    m_lastConnectedMAC = mac;
+    notifyAddress = (m_settings["NOTP"] == "1");
+    for (Peripheral& peripheral : m_peripherals) {
+      if (peripheral.mac == mac) {
+        pendingData.swap(peripheral.pendingData);
+      }
+    }
+  }
+
+  respond(notifyAddress ? "OK+CONN:" + mac : std::string("OK+CONN"));
+
+  std::chrono::microseconds delay { 0 };
+  for (std::size_t offset = 0; offset < pendingData.size(); offset += RemotePacketSize) {
+    delay += RemotePacketInterval;
+    respond(pendingData.substr(offset, RemotePacketSize), delay);
+  }
+}
+
+void HM10Emulator::lostConnection() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_connected = false;
+    m_connectedMAC.clear();
+  }
+  respond("OK+LOST");
+}
+
+}
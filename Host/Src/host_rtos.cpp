@@ -0,0 +1,456 @@
+/*
+ * host_rtos.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include <cmsis_os2.h>
+#include <message_buffer.h>
+#include <stream_buffer.h>
+#include <timers.h>
+#include "host_uart.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct HostThread {
+  std::mutex lock { };
+  std::condition_variable flagsChanged { };
+  uint32_t flags { 0 };
+};
+
+struct HostQueue {
+  std::mutex lock { };
+  std::condition_variable changed { };
+  std::deque<std::vector<uint8_t>> messages { };
+  std::size_t capacity { 0 };
+  std::size_t messageSize { 0 };
+};
+
+struct HostEventFlags {
+  std::mutex lock { };
+  std::condition_variable changed { };
+  uint32_t flags { 0 };
+};
+
+struct PendedCall {
+  PendedFunction_t function;
+  void* parameter1;
+  uint32_t parameter2;
+};
+
+// FreeRTOS timer service task equivalent - calls the pended functions one by one, in order
+struct TimerService {
+  // configTIMER_QUEUE_LENGTH of the example project
+  static constexpr std::size_t QueueLength { 10 };
+
+  std::mutex lock { };
+  std::condition_variable changed { };
+  std::deque<PendedCall> calls { };
+};
+
+}
+
+// Name comes from the FreeRTOS handle typedef. Storage area given to the static create is ignored.
+struct StreamBufferDef_t {
+  std::mutex lock { };
+  std::condition_variable changed { };
+  std::deque<uint8_t> data { };
+  std::size_t capacity { 0 };
+  bool messages { false };
+};
+
+namespace {
+
+// Message buffers prefix every message with its length
+constexpr std::size_t MessageHeaderSize { sizeof(std::size_t) };
+
+// Bytes of `length` that can be written right now - whole message or nothing, in message mode
+std::size_t writableBytes(StreamBufferDef_t const* buffer, std::size_t length) {
+  std::size_t const space = buffer->capacity - buffer->data.size();
+  if (buffer->messages) {
+    return space >= length + MessageHeaderSize ? length : 0;
+  }
+  return length < space ? length : space;
+}
+
+std::size_t writeBytes(StreamBufferDef_t* buffer, void const* data, std::size_t length) {
+  std::size_t const count = writableBytes(buffer, length);
+  if (count == 0) {
+    return 0;
+  }
+
+  if (buffer->messages) {
+    uint8_t header[MessageHeaderSize] { };
+    std::memcpy(header, &count, sizeof(header));
+    buffer->data.insert(buffer->data.end(), header, header + sizeof(header));
+  }
+  uint8_t const* const bytes = static_cast<uint8_t const*>(data);
+  buffer->data.insert(buffer->data.end(), bytes, bytes + count);
+  buffer->changed.notify_all();
+  return count;
+}
+
+// Threads not created with osThreadNew (like main) get their state on the first use
+thread_local HostThread* currentThread { nullptr };
+
+HostThread* current() {
+  if (currentThread == nullptr) {
+    // Never freed - thread IDs must stay valid for the whole program, like on the MCU
+    currentThread = new HostThread { };
+  }
+  return currentThread;
+}
+
+// Started on the first use. Never freed - the thread runs until the program ends, like the timer task
+TimerService& timerService() {
+  static TimerService* const service = []() {
+    TimerService* const instance = new TimerService { };
+    std::thread([instance]() {
+      while (true) {
+        std::unique_lock<std::mutex> lock(instance->lock);
+        instance->changed.wait(lock, [instance]() { return !instance->calls.empty(); });
+        PendedCall const call = instance->calls.front();
+        instance->calls.pop_front();
+        instance->changed.notify_all();
+        lock.unlock();
+        call.function(call.parameter1, call.parameter2);
+      }
+    }).detach();
+    return instance;
+  }();
+  return *service;
+}
+
+// Waits until `predicate` is true or the timeout passes, osWaitForever waits indefinitely
+template <typename Predicate>
+bool waitFor(std::condition_variable& condition, std::unique_lock<std::mutex>& lock, uint32_t timeout,
+             Predicate predicate) {
+  if (timeout == osWaitForever) {
+    condition.wait(lock, predicate);
+    return true;
+  }
+  return condition.wait_for(lock, std::chrono::milliseconds(timeout), predicate);
+}
+
+// configASSERT equivalent - on the MCU, the wrong variant of the API for the context corrupts the scheduler state
+void assertContext(bool interruptAPI, char const* function) {
+  if (HostUART::inInterrupt() != interruptAPI) {
+    std::fprintf(stderr, "%s called from %s\n", function, (interruptAPI ? "a task" : "an interrupt"));
+    std::abort();
+  }
+}
+
+BaseType_t pendFunctionCall(PendedFunction_t function, void* parameter1, uint32_t parameter2, TickType_t ticksToWait) {
+  TimerService& service = timerService();
+  std::unique_lock<std::mutex> lock(service.lock);
+  uint32_t const timeout = (ticksToWait == portMAX_DELAY ? osWaitForever : ticksToWait);
+  bool const queued = waitFor(service.changed, lock, timeout, [&service]() {
+    return service.calls.size() < TimerService::QueueLength;
+  });
+  if (!queued) {
+    return pdFAIL;
+  }
+  service.calls.push_back({ function, parameter1, parameter2 });
+  service.changed.notify_all();
+  return pdPASS;
+}
+
+}
+
+extern "C" {
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void* argument, const osThreadAttr_t*) {
+  if (func == nullptr) {
+    return nullptr;
+  }
+
+  HostThread* const thread = new HostThread { };
+  std::thread([thread, func, argument]() {
+    currentThread = thread;
+    func(argument);
+  }).detach();
+  return thread;
+}
+
+osThreadId_t osThreadGetId(void) {
+  return current();
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags) {
+  if (thread_id == nullptr || (flags & osFlagsError) != 0) {
+    return osFlagsErrorParameter;
+  }
+
+  HostThread* const thread = static_cast<HostThread*>(thread_id);
+  std::lock_guard<std::mutex> lock(thread->lock);
+  thread->flags |= flags;
+  thread->flagsChanged.notify_all();
+  return thread->flags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout) {
+  HostThread* const thread = current();
+  std::unique_lock<std::mutex> lock(thread->lock);
+  bool const all = (options & osFlagsWaitAll) != 0;
+  bool const satisfied = waitFor(thread->flagsChanged, lock, timeout, [&]() {
+    return all ? (thread->flags & flags) == flags : (thread->flags & flags) != 0;
+  });
+  if (!satisfied) {
+    return osFlagsErrorTimeout;
+  }
+
+  uint32_t const result = thread->flags;
+  if ((options & osFlagsNoClear) == 0) {
+    thread->flags &= ~flags;
+  }
+  return result;
+}
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t*) {
+  if (msg_count == 0 || msg_size == 0) {
+    return nullptr;
+  }
+
+  HostQueue* const queue = new HostQueue { };
+  queue->capacity = msg_count;
+  queue->messageSize = msg_size;
+  return queue;
+}
+
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void* msg_ptr, uint8_t, uint32_t timeout) {
+  if (mq_id == nullptr || msg_ptr == nullptr) {
+    return osErrorParameter;
+  }
+
+  HostQueue* const queue = static_cast<HostQueue*>(mq_id);
+  std::unique_lock<std::mutex> lock(queue->lock);
+  if (!waitFor(queue->changed, lock, timeout, [queue]() {
+    return queue->messages.size() < queue->capacity;
+  })) {
+    return timeout == 0 ? osErrorResource : osErrorTimeout;
+  }
+
+  uint8_t const* const message = static_cast<uint8_t const*>(msg_ptr);
+  queue->messages.emplace_back(message, message + queue->messageSize);
+  queue->changed.notify_all();
+  return osOK;
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void* msg_ptr, uint8_t* msg_prio, uint32_t timeout) {
+  if (mq_id == nullptr || msg_ptr == nullptr) {
+    return osErrorParameter;
+  }
+
+  HostQueue* const queue = static_cast<HostQueue*>(mq_id);
+  std::unique_lock<std::mutex> lock(queue->lock);
+  if (!waitFor(queue->changed, lock, timeout, [queue]() {
+    return !queue->messages.empty();
+  })) {
+    return timeout == 0 ? osErrorResource : osErrorTimeout;
+  }
+
+  std::memcpy(msg_ptr, queue->messages.front().data(), queue->messageSize);
+  queue->messages.pop_front();
+  if (msg_prio != nullptr) {
+    *msg_prio = 0;
+  }
+  queue->changed.notify_all();
+  return osOK;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id) {
+  if (mq_id == nullptr) {
+    return 0;
+  }
+
+  HostQueue* const queue = static_cast<HostQueue*>(mq_id);
+  std::lock_guard<std::mutex> lock(queue->lock);
+  return static_cast<uint32_t>(queue->messages.size());
+}
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t*) {
+  return new HostEventFlags { };
+}
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+  if (ef_id == nullptr || (flags & osFlagsError) != 0) {
+    return osFlagsErrorParameter;
+  }
+
+  HostEventFlags* const events = static_cast<HostEventFlags*>(ef_id);
+  std::lock_guard<std::mutex> lock(events->lock);
+  events->flags |= flags;
+  events->changed.notify_all();
+  return events->flags;
+}
+
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+  if (ef_id == nullptr) {
+    return osFlagsErrorParameter;
+  }
+
+  HostEventFlags* const events = static_cast<HostEventFlags*>(ef_id);
+  std::lock_guard<std::mutex> lock(events->lock);
+  uint32_t const previous = events->flags;
+  events->flags &= ~flags;
+  return previous;
+}
+
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
+  if (ef_id == nullptr) {
+    return 0;
+  }
+
+  HostEventFlags* const events = static_cast<HostEventFlags*>(ef_id);
+  std::lock_guard<std::mutex> lock(events->lock);
+  return events->flags;
+}
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout) {
+  if (ef_id == nullptr) {
+    return osFlagsErrorParameter;
+  }
+
+  HostEventFlags* const events = static_cast<HostEventFlags*>(ef_id);
+  std::unique_lock<std::mutex> lock(events->lock);
+  bool const all = (options & osFlagsWaitAll) != 0;
+  bool const satisfied = waitFor(events->changed, lock, timeout, [&]() {
+    return all ? (events->flags & flags) == flags : (events->flags & flags) != 0;
+  });
+  if (!satisfied) {
+    return osFlagsErrorTimeout;
+  }
+
+  uint32_t const result = events->flags;
+  if ((options & osFlagsNoClear) == 0) {
+    events->flags &= ~flags;
+  }
+  return result;
+}
+
+StreamBufferHandle_t xStreamBufferGenericCreate(size_t xBufferSizeBytes, size_t, BaseType_t xIsMessageBuffer) {
+  if (xBufferSizeBytes == 0) {
+    return nullptr;
+  }
+
+  StreamBufferDef_t* const buffer = new StreamBufferDef_t { };
+  buffer->capacity = xBufferSizeBytes;
+  buffer->messages = xIsMessageBuffer != pdFALSE;
+  return buffer;
+}
+
+StreamBufferHandle_t xStreamBufferGenericCreateStatic(size_t xBufferSizeBytes, size_t xTriggerLevelBytes,
+                                                      BaseType_t xIsMessageBuffer, uint8_t* const,
+                                                      StaticStreamBuffer_t* const) {
+  return xStreamBufferGenericCreate(xBufferSizeBytes, xTriggerLevelBytes, xIsMessageBuffer);
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t xStreamBuffer, const void* pvTxData, size_t xDataLengthBytes,
+                         TickType_t xTicksToWait) {
+  if (xStreamBuffer == nullptr || pvTxData == nullptr || xDataLengthBytes == 0) {
+    return 0;
+  }
+
+  std::unique_lock<std::mutex> lock(xStreamBuffer->lock);
+  waitFor(xStreamBuffer->changed, lock, xTicksToWait, [xStreamBuffer, xDataLengthBytes]() {
+    return writableBytes(xStreamBuffer, xDataLengthBytes) > 0;
+  });
+  return writeBytes(xStreamBuffer, pvTxData, xDataLengthBytes);
+}
+
+size_t xStreamBufferSendFromISR(StreamBufferHandle_t xStreamBuffer, const void* pvTxData, size_t xDataLengthBytes,
+                                BaseType_t* const pxHigherPriorityTaskWoken) {
+  if (xStreamBuffer == nullptr || pvTxData == nullptr || xDataLengthBytes == 0) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(xStreamBuffer->lock);
+  std::size_t const sent = writeBytes(xStreamBuffer, pvTxData, xDataLengthBytes);
+  if (sent > 0 && pxHigherPriorityTaskWoken != nullptr) {
+    *pxHigherPriorityTaskWoken = pdTRUE;
+  }
+  return sent;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t xStreamBuffer, void* pvRxData, size_t xBufferLengthBytes,
+                            TickType_t xTicksToWait) {
+  if (xStreamBuffer == nullptr || pvRxData == nullptr) {
+    return 0;
+  }
+
+  std::unique_lock<std::mutex> lock(xStreamBuffer->lock);
+  if (!waitFor(xStreamBuffer->changed, lock, xTicksToWait, [xStreamBuffer]() {
+    return !xStreamBuffer->data.empty();
+  })) {
+    return 0;
+  }
+
+  std::size_t count { xBufferLengthBytes };
+  if (xStreamBuffer->messages) {
+    uint8_t header[MessageHeaderSize] { };
+    std::copy_n(xStreamBuffer->data.begin(), sizeof(header), header);
+    std::size_t length { 0 };
+    std::memcpy(&length, header, sizeof(length));
+    // Message that doesn't fit stays in the buffer, like in FreeRTOS
+    if (length > xBufferLengthBytes) {
+      return 0;
+    }
+    xStreamBuffer->data.erase(xStreamBuffer->data.begin(), xStreamBuffer->data.begin() + sizeof(header));
+    count = length;
+  } else if (count > xStreamBuffer->data.size()) {
+    count = xStreamBuffer->data.size();
+  }
+
+  std::copy_n(xStreamBuffer->data.begin(), count, static_cast<uint8_t*>(pvRxData));
+  xStreamBuffer->data.erase(xStreamBuffer->data.begin(), xStreamBuffer->data.begin() + count);
+  xStreamBuffer->changed.notify_all();
+  return count;
+}
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t xStreamBuffer) {
+  if (xStreamBuffer == nullptr) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(xStreamBuffer->lock);
+  return xStreamBuffer->capacity - xStreamBuffer->data.size();
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer) {
+  if (xStreamBuffer == nullptr) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(xStreamBuffer->lock);
+  return xStreamBuffer->data.size();
+}
+
+BaseType_t xTimerPendFunctionCall(PendedFunction_t xFunctionToPend, void* pvParameter1, uint32_t ulParameter2,
+                                  TickType_t xTicksToWait) {
+  assertContext(false, "xTimerPendFunctionCall");
+  return pendFunctionCall(xFunctionToPend, pvParameter1, ulParameter2, xTicksToWait);
+}
+
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t xFunctionToPend, void* pvParameter1, uint32_t ulParameter2,
+                                         BaseType_t* pxHigherPriorityTaskWoken) {
+  assertContext(true, "xTimerPendFunctionCallFromISR");
+  BaseType_t const result = pendFunctionCall(xFunctionToPend, pvParameter1, ulParameter2, 0);
+  if (result == pdPASS && pxHigherPriorityTaskWoken != nullptr) {
+    *pxHigherPriorityTaskWoken = pdTRUE;
+  }
+  return result;
+}
+
+}
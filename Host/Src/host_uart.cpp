@@ -0,0 +1,267 @@
+/*
+ * host_uart.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+#include "host_uart.hpp"
+#include <cmsis_os2.h>
+
+#include <chrono>
+#include <map>
+#include <thread>
+
+namespace HostUART {
+
+namespace {
+
+struct Port {
+  TransmitHook hook { nullptr };
+  void* context { nullptr };
+  InterruptHandler handler { nullptr };
+};
+
+std::map<UART_HandleTypeDef*, Port>& ports() {
+  static std::map<UART_HandleTypeDef*, Port> instance { };
+  return instance;
+}
+
+std::mutex& portsLock() {
+  static std::mutex instance { };
+  return instance;
+}
+
+Port portOf(UART_HandleTypeDef* uart) {
+  std::lock_guard<std::mutex> lock(portsLock());
+  auto const it = ports().find(uart);
+  return (it != ports().end() ? it->second : Port { });
+}
+
+std::chrono::steady_clock::time_point const StartTime { std::chrono::steady_clock::now() };
+
+// Nesting depth of __disable_irq in the current thread, PRIMASK equivalent
+thread_local std::uint32_t interruptMaskDepth { 0 };
+// Nesting depth of the interrupt handlers running in the current thread, IPSR equivalent
+thread_local std::uint32_t interruptDepth { 0 };
+
+// Marks the handler call as the interrupt context for its lifetime
+struct InterruptContext {
+  InterruptContext() {
+    interruptDepth++;
+  }
+
+  ~InterruptContext() {
+    interruptDepth--;
+  }
+};
+
+}
+
+void attach(UART_HandleTypeDef* uart, TransmitHook hook, void* context) {
+  std::lock_guard<std::mutex> lock(portsLock());
+  ports()[uart].hook = hook;
+  ports()[uart].context = context;
+}
+
+void detach(UART_HandleTypeDef* uart) {
+  std::lock_guard<std::mutex> lock(portsLock());
+  ports()[uart].hook = nullptr;
+  ports()[uart].context = nullptr;
+}
+
+void setInterruptHandler(UART_HandleTypeDef* uart, InterruptHandler handler) {
+  std::lock_guard<std::mutex> lock(portsLock());
+  ports()[uart].handler = handler;
+}
+
+void write(UART_HandleTypeDef* uart, std::uint8_t const* data, std::size_t length) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  // DMA keeps running as long as it's enabled in UART, even if HAL state says otherwise (after HAL_UART_Init)
+  if ((uart->Instance->CR3 & USART_CR3_DMAR) == 0 || uart->pRxBuffPtr == nullptr || uart->RxXferSize == 0) {
+    // Nobody's listening - in real hardware, it'd be an overrun
+    uart->Instance->SR |= USART_SR_ORE;
+    return;
+  }
+
+  DMA_Stream_TypeDef* const stream = uart->hdmarx->Instance;
+  for (std::size_t i = 0; i < length; i++) {
+    uart->pRxBuffPtr[uart->RxXferSize - stream->NDTR] = data[i];
+    stream->NDTR--;
+    if (stream->NDTR == 0) {
+      stream->NDTR = uart->RxXferSize;
+    }
+  }
+}
+
+void signalIdle(UART_HandleTypeDef* uart) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  uart->Instance->SR |= USART_SR_IDLE;
+  Port const port = portOf(uart);
+  if (port.handler != nullptr && (uart->Instance->CR1 & USART_CR1_IDLEIE) != 0) {
+    InterruptContext const context { };
+    port.handler();
+  }
+}
+
+void deliver(UART_HandleTypeDef* uart, std::uint8_t const* data, std::size_t length) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  write(uart, data, length);
+  signalIdle(uart);
+}
+
+void completeTransmit(UART_HandleTypeDef* uart) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  if (uart->gState != HAL_UART_STATE_BUSY_TX) {
+    return;
+  }
+  uart->gState = HAL_UART_STATE_READY;
+  uart->Instance->SR |= USART_SR_TC;
+  InterruptContext const context { };
+  HAL_UART_TxCpltCallback(uart);
+}
+
+void raiseError(UART_HandleTypeDef* uart, std::uint32_t errorCode, bool stopReception) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  uart->ErrorCode |= errorCode;
+  if (stopReception) {
+    uart->RxState = HAL_UART_STATE_READY;
+    uart->Instance->CR3 &= ~USART_CR3_DMAR;
+  }
+  InterruptContext const context { };
+  HAL_UART_ErrorCallback(uart);
+}
+
+std::uint32_t transferTime(UART_HandleTypeDef const* uart, std::size_t bytes) {
+  std::uint32_t const baudrate = (uart->Init.BaudRate > 0 ? uart->Init.BaudRate : 115200);
+  // 8N1 - 10 bits per byte
+  return static_cast<std::uint32_t>((static_cast<std::uint64_t>(bytes) * 10 * 1000000) / baudrate);
+}
+
+std::recursive_mutex& interruptLock() {
+  static std::recursive_mutex instance { };
+  return instance;
+}
+
+bool inInterrupt() {
+  return interruptDepth > 0;
+}
+
+}
+
+using namespace HostUART;
+
+extern "C" {
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  huart->gState = HAL_UART_STATE_READY;
+  huart->RxState = HAL_UART_STATE_READY;
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size) {
+  {
+    std::lock_guard<std::recursive_mutex> lock(interruptLock());
+    if (huart->gState == HAL_UART_STATE_BUSY_TX) {
+      return HAL_BUSY;
+    }
+    if (pData == nullptr || Size == 0) {
+      return HAL_ERROR;
+    }
+    huart->pTxBuffPtr = pData;
+    huart->TxXferSize = Size;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->Instance->SR &= ~USART_SR_TC;
+  }
+
+  Port const port = portOf(huart);
+  if (port.hook != nullptr) {
+    port.hook(port.context, pData, Size);
+  } else {
+    completeTransmit(huart);
+  }
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  if (huart->RxState == HAL_UART_STATE_BUSY_RX) {
+    return HAL_BUSY;
+  }
+  if (pData == nullptr || Size == 0 || huart->hdmarx == nullptr) {
+    return HAL_ERROR;
+  }
+  huart->pRxBuffPtr = pData;
+  huart->RxXferSize = Size;
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  huart->hdmarx->Instance->NDTR = Size;
+  huart->Instance->CR3 |= USART_CR3_DMAR;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef* huart) {
+  std::lock_guard<std::recursive_mutex> lock(interruptLock());
+  huart->RxState = HAL_UART_STATE_READY;
+  huart->gState = HAL_UART_STATE_READY;
+  huart->Instance->CR3 &= ~(USART_CR3_DMAR | USART_CR3_DMAT);
+  return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+  (void) huart;
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+  (void) huart;
+}
+
+uint32_t HAL_GetTick(void) {
+  auto const elapsed = std::chrono::steady_clock::now() - StartTime;
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+void HAL_Delay(uint32_t Delay) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(Delay));
+}
+
+void __disable_irq(void) {
+  interruptLock().lock();
+  interruptMaskDepth++;
+}
+
+void __enable_irq(void) {
+  while (interruptMaskDepth > 0) {
+    interruptMaskDepth--;
+    interruptLock().unlock();
+  }
+}
+
+uint32_t __get_PRIMASK(void) {
+  return interruptMaskDepth;
+}
+
+void __set_PRIMASK(uint32_t priMask) {
+  // Restoring the previous state - unmask down to the saved depth
+  while (interruptMaskDepth > priMask) {
+    interruptMaskDepth--;
+    interruptLock().unlock();
+  }
+}
+
+osStatus_t osDelay(uint32_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+  return osOK;
+}
+
+uint32_t osKernelGetTickCount(void) {
+  return HAL_GetTick();
+}
+
+uint32_t osKernelGetTickFreq(void) {
+  return 1000;
+}
+
+}
@@ -0,0 +1,569 @@
+/*
+ * main.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Host version of the example from Core/Src/freertos.cpp - the same provisioning sequence,
+ * running against the HM-10 emulator instead of the real module.
+ */
+
+#include <hm10.hpp>
+#include <hm10_beacon.hpp>
+#include <hm10_central.hpp>
+#include <hm10_config.hpp>
+#include <hm10_coroutine.hpp>
+#include <hm10_debug.hpp>
+#include <hm10_events.hpp>
+#include <hm10_link_quality.hpp>
+#include <hm10_scheduler.hpp>
+#include <hm10_service.hpp>
+#include <hm10_supervisor.hpp>
+#include <message_buffer.h>
+#include "hm10_emulator.hpp"
+#include "host_uart.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+USART_TypeDef usart1 { };
+DMA_Stream_TypeDef dma2Stream2 { };
+DMA_Stream_TypeDef dma2Stream7 { };
+DMA_HandleTypeDef hdma_usart1_rx { &dma2Stream2 };
+DMA_HandleTypeDef hdma_usart1_tx { &dma2Stream7 };
+UART_HandleTypeDef huart1 { &usart1, { 115200, 0, 0, 0, 0, 0, 0 }, nullptr, 0, nullptr, 0, &hdma_usart1_tx,
+                            &hdma_usart1_rx, HAL_UART_STATE_READY, HAL_UART_STATE_READY, 0 };
+
+HM10::HM10 hm10(&huart1);
+#ifdef HM10_CAPTURE
+HM10::Capture capture;
+#endif
+
+char hm_message_buffer[128] { };
+volatile bool message_received = false;
+int failures = 0;
+
+void check(bool condition, char const* description) {
+  std::printf("[%s] %s\n", (condition ? " OK " : "FAIL"), description);
+  if (!condition) {
+    failures++;
+  }
+}
+
+void HM10_UART_HandleIdleLine() {
+  if (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_IDLE)) {
+    __HAL_UART_CLEAR_IDLEFLAG(&huart1);
+    hm10.idleLineDetected();
+  }
+}
+
+extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+  if (huart == &huart1) {
+    hm10.transmitCompleted();
+  }
+}
+
+extern "C" void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+  if (huart == &huart1) {
+    hm10.errorOccurred();
+  }
+}
+
+void dataCallback(char* data, std::size_t length) {
+  std::memcpy(hm_message_buffer, data, length);
+  hm_message_buffer[length] = '\0';
+  message_received = true;
+}
+
+void connectedCallback(HM10::MACAddress const& mac) {
+  std::printf("Connected to master with MAC address %s\n", mac.address);
+}
+
+void disconnectedCallback() {
+  std::printf("Disconnected from master!\n");
+}
+
+// Event bus listeners, each one counts its events
+struct EventCounter {
+  int connected { 0 };
+  int disconnected { 0 };
+  std::size_t dataBytes { 0 };
+};
+
+void countConnected(void* context, HM10::MACAddress const&) {
+  static_cast<EventCounter*>(context)->connected++;
+}
+
+void countDisconnected(void* context) {
+  static_cast<EventCounter*>(context)->disconnected++;
+}
+
+void countData(void* context, char const*, std::size_t length) {
+  static_cast<EventCounter*>(context)->dataBytes += length;
+}
+
+#ifdef __cpp_impl_coroutine
+struct AsyncResults {
+  HM10::Role role { HM10::Role::Invalid };
+  HM10::DeviceName name { };
+  bool renamed { false };
+  bool alive { false };
+};
+
+// Two flows interleaved on one thread - the second one sleeps, so the first one gets the module first
+HM10::Task readConfiguration(HM10::AsyncHM10& module, AsyncResults& results) {
+  results.role = co_await module.role();
+  co_await module.executor().sleep(20);
+  results.name = co_await module.name();
+}
+
+HM10::Task renameModule(HM10::AsyncHM10& module, AsyncResults& results) {
+  co_await module.executor().sleep(10);
+  results.renamed = co_await module.setName("hm10async");
+  results.alive = co_await module.isAlive();
+}
+#endif
+
+int main() {
+  Host::HM10Emulator emulator(&huart1);
+  HostUART::setInterruptHandler(&huart1, HM10_UART_HandleIdleLine);
+
+  auto const startTime = std::chrono::steady_clock::now();
+
+#ifdef HM10_CAPTURE
+  hm10.setCapture(&capture);
+#endif
+  check(hm10.initialize(true) == HAL_OK, "initialize");
+  check(hm10.isAlive(), "isAlive");
+
+  check(hm10.factoryReset(), "factoryReset");
+  check(hm10.setBaudRate(HM10::Baudrate::Baud230400), "setBaudRate(230400)");
+  check(emulator.baudrate() == 230400 && hm10.isAlive(), "alive after baudrate change");
+
+  HM10::Version const version = hm10.firmwareVersion();
+  std::printf("Firmware version: %s\n", version.version);
+  check(std::strcmp(version.version, "HMSoft V709") == 0, "firmwareVersion");
+  check(hm10.firmware() == HM10::Firmware::HMSoftV7, "firmware detected at initialize");
+
+  // V6xx has no AT+UART - the command fails without waiting for the response timeout
+  emulator.setFirmwareVersion("HMSoft V605");
+  check(hm10.detectFirmware() == HM10::Firmware::HMSoftV6 && !hm10.supports("AT+UART"), "V6xx firmware detected");
+  auto const rejectStart = std::chrono::steady_clock::now();
+  check(!hm10.setUARTShutdownOnSleep(true) && hm10.commandStatistics("UART").unsupported == 1
+        && std::chrono::steady_clock::now() - rejectStart < std::chrono::milliseconds(10), "unsupported command rejected");
+  emulator.setFirmwareVersion("HMSoft V709");
+  check(hm10.detectFirmware() == HM10::Firmware::HMSoftV7 && hm10.supports("AT+UART"), "V7xx firmware detected");
+
+  hm10.setDataCallback(dataCallback);
+  // They print, so they don't run in the "interrupt", like in the MCU example
+  hm10.setDeviceConnectedCallback(connectedCallback, HM10::CallbackDispatch::Deferred);
+  hm10.setDeviceDisconnectedCallback(disconnectedCallback, HM10::CallbackDispatch::Deferred);
+
+  // Logging, LED, metrics... - any amount of listeners on top of the callbacks
+  HM10::EventBus events;
+  EventCounter firstCounter { };
+  EventCounter secondCounter { };
+  check(events.initialize(), "event bus");
+  for (EventCounter* counter : { &firstCounter, &secondCounter }) {
+    events.subscribeConnected(countConnected, counter);
+    events.subscribeDisconnected(countDisconnected, counter);
+    events.subscribeData(countData, counter);
+  }
+  hm10.setEventBus(&events);
+
+  check(hm10.setAutomaticMode(true) && hm10.automaticMode(), "automatic mode");
+  check(hm10.setAutoSleep(false) && !hm10.autoSleep(), "auto sleep");
+  check(hm10.setWorkMode(HM10::WorkMode::Transmission)
+        && hm10.workMode() == HM10::WorkMode::Transmission, "work mode");
+  check(hm10.setRole(HM10::Role::Peripheral) && hm10.role() == HM10::Role::Peripheral, "role");
+  check(hm10.setBondingMode(HM10::BondMode::NoPin) && hm10.bondingMode() == HM10::BondMode::NoPin,
+        "bonding mode");
+  check(hm10.setName("hm10test") && std::strcmp(hm10.name().name, "hm10test") == 0, "name");
+  check(hm10.setServiceUUID(0xDEAD) && hm10.serviceUUID() == 0xDEAD, "service UUID");
+  check(hm10.setCharacteristicValue(0xBEEF) && hm10.characteristicValue() == 0xBEEF, "characteristic value");
+  check(hm10.setNotificationsState(true) && hm10.notificationsState(), "notifications");
+  check(hm10.setMACAddress("AABBCCDDEEFF") && std::strcmp(hm10.macAddress().address, "AABBCCDDEEFF") == 0,
+        "MAC address");
+
+  check(hm10.sleep() && hm10.powerState() == HM10::PowerState::Asleep, "sleep");
+  check(hm10.wakeUp() && hm10.powerState() == HM10::PowerState::Awake, "wake up");
+  std::printf("Wake up latency: %u ms\n", static_cast<unsigned>(hm10.wakeUpLatency()));
+
+  // Auto sleep: after the driver's idle time the state is unknown. The still awake module answers AT right away,
+  // instead of ignoring the burst for the whole timeout. The one that fell asleep ignores AT (100 ms) and gets
+  // the burst.
+  check(hm10.setAutoSleep(true) && hm10.powerState() == HM10::PowerState::Awake, "auto sleep enabled");
+  osDelay(120);
+  std::uint32_t wakeUpStart = platformTicks();
+  bool const unknownAfterIdle = hm10.powerState() == HM10::PowerState::Unknown;
+  check(unknownAfterIdle && hm10.wakeUp() && platformTicks() - wakeUpStart < 100 && !emulator.isAsleep(),
+        "wake up an awake module in auto sleep mode");
+  osDelay(300);
+  wakeUpStart = platformTicks();
+  bool const wokenUp = hm10.powerState() == HM10::PowerState::Unknown && hm10.wakeUp();
+  std::uint32_t const wakeUpTime = platformTicks() - wakeUpStart;
+  check(wokenUp && !emulator.isAsleep() && hm10.powerState() == HM10::PowerState::Awake && wakeUpTime >= 100
+        && wakeUpTime < 500,
+        "wake up a module that fell asleep by itself");
+  check(hm10.setAutoSleep(false) && !hm10.autoSleep(), "auto sleep disabled");
+
+#ifdef __cpp_impl_coroutine
+  HM10::Executor executor;
+  HM10::AsyncHM10 asyncModule(hm10, executor);
+  AsyncResults asyncResults { };
+  executor.spawn(readConfiguration(asyncModule, asyncResults));
+  executor.spawn(renameModule(asyncModule, asyncResults));
+  executor.run();
+  check(asyncResults.role == HM10::Role::Peripheral && asyncResults.renamed && asyncResults.alive
+        && std::strcmp(asyncResults.name.name, "hm10async") == 0, "coroutine flows");
+#endif
+
+  auto const provisioningTime = std::chrono::steady_clock::now() - startTime;
+  std::printf("Provisioning took %lld ms\n",
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(provisioningTime).count()));
+
+  emulator.connectRemote("112233445566");
+  osDelay(50);
+  check(hm10.isConnected(), "remote connected");
+  check(events.wait(HM10::EventBus::Connected, 100) == HM10::EventBus::Connected && firstCounter.connected == 1
+        && secondCounter.connected == 1, "connected event");
+
+  emulator.sendFromRemote("hello from master");
+  for (int i = 0; i < 100 && !message_received; i++) {
+    osDelay(1);
+  }
+  check(message_received && std::strcmp(hm_message_buffer, "hello from master") == 0, "data received");
+
+  char const* response = "test response";
+  check(hm10.sendData(reinterpret_cast<std::uint8_t const*>(response), std::strlen(response)), "sendData");
+  osDelay(10);
+  check(emulator.takeRemoteData() == response, "data sent");
+
+  // AT+RSSI? while connected goes over the link - only an HM-10 peer in remote control mode answers it
+  int const rssiWithoutRemoteControl = hm10.rssi();
+  bool const queryForwarded = emulator.takeRemoteData() == "AT+RSSI?";
+  emulator.setRemoteControl(true);
+  int const remoteRSSI = hm10.rssi();
+  check(rssiWithoutRemoteControl == 0 && queryForwarded && remoteRSSI < -50 && hm10.isConnected(),
+        "remote RSSI query");
+
+  // RSSI sampler - the emulated peer answers -55 to -74 dBm
+  HM10::LinkQualitySampler sampler(hm10);
+  sampler.setPeriod(0);
+  sampler.setQuietTime(0);
+  bool const sampled = sampler.poll() && sampler.poll() && sampler.poll();
+  sampler.setQuietTime(100000);
+  bool const skipped = !sampler.poll();
+  sampler.setPeriod(100000);
+  bool const throttled = !sampler.poll();
+  HM10::LinkQuality const quality = sampler.snapshot();
+  check(sampled && skipped && throttled && quality.samples == 3 && quality.skippedSamples == 1
+        && quality.failedSamples == 0 && quality.minRSSI >= -74 && quality.maxRSSI <= -55
+        && quality.minRSSI < quality.maxRSSI && quality.lastRSSI >= quality.minRSSI
+        && quality.average() >= quality.minRSSI && quality.average() <= quality.maxRSSI, "link quality sampler");
+  // While the traffic flows, a skip is counted once per period, not per call
+  sampler.setPeriod(50);
+  osDelay(60);
+  bool const skipCounted = !sampler.poll() && sampler.snapshot().skippedSamples == 2;
+  bool const repeatIgnored = !sampler.poll() && !sampler.poll() && sampler.snapshot().skippedSamples == 2;
+  osDelay(60);
+  bool const nextSkipCounted = !sampler.poll() && sampler.snapshot().skippedSamples == 3;
+  check(skipCounted && repeatIgnored && nextSkipCounted, "link quality sampler counts a skip once per period");
+  sampler.reset();
+  check(sampler.snapshot().samples == 0, "link quality sampler reset");
+
+  // Back-to-back frames are queued as separate messages, the one that doesn't fit is dropped and counted
+  StaticMessageBuffer_t messageBufferControlBlock { };
+  std::uint8_t messageBufferStorage[64] { };
+  MessageBufferHandle_t const messages = xMessageBufferCreateStatic(sizeof(messageBufferStorage),
+                                                                    messageBufferStorage, &messageBufferControlBlock);
+  hm10.setDataMessageBuffer(messages);
+  std::string const tooLong(40, 'x');
+  emulator.sendFromRemote("first");
+  emulator.sendFromRemote("second");
+  emulator.sendFromRemote(tooLong);
+  osDelay(50);
+  char frame[HM10_BUFFER_SIZE] { };
+  std::size_t const firstLength = xMessageBufferReceive(messages, frame, sizeof(frame), 100);
+  bool const firstReceived = std::string(frame, firstLength) == "first";
+  std::size_t const secondLength = xMessageBufferReceive(messages, frame, sizeof(frame), 100);
+  bool const secondReceived = std::string(frame, secondLength) == "second";
+  check(firstReceived && secondReceived && xMessageBufferReceive(messages, frame, sizeof(frame), 0) == 0
+        && hm10.linkStatistics().droppedDataBytes == tooLong.size(), "message buffer");
+  hm10.setDataMessageBuffer(nullptr);
+
+  // Overrun in the middle of a message stops RX DMA - the driver restarts it and drops the broken message
+  char const* brokenMessage = "broken";
+  HostUART::write(&huart1, reinterpret_cast<std::uint8_t const*>(brokenMessage), std::strlen(brokenMessage));
+  HostUART::raiseError(&huart1, HAL_UART_ERROR_ORE, true);
+  message_received = false;
+  emulator.sendFromRemote("after overrun");
+  for (int i = 0; i < 100 && !message_received; i++) {
+    osDelay(1);
+  }
+  HM10::LinkStatistics const recovery = hm10.linkStatistics();
+  check(message_received && std::strcmp(hm_message_buffer, "after overrun") == 0 && recovery.overruns == 1
+        && recovery.rxRestarts == 1 && recovery.discardedBytes == std::strlen(brokenMessage), "overrun recovery");
+
+  // Reply with a gap longer than one character - two messages with idle line framing, one with the timeout
+  // (TIM interrupt equivalent - ticks every 1ms, serialized with the UART "interrupt")
+  std::atomic<bool> ticking { true };
+  std::thread ticker([&ticking]() {
+    while (ticking) {
+      {
+        std::lock_guard<std::recursive_mutex> lock(HostUART::interruptLock());
+        hm10.timerTick();
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  auto const deliverFragments = [](char const* first, char const* second) {
+    std::uint32_t const framesBefore = hm10.linkStatistics().framesReceived;
+    message_received = false;
+    HostUART::deliver(&huart1, reinterpret_cast<std::uint8_t const*>(first), std::strlen(first));
+    osDelay(2);
+    HostUART::deliver(&huart1, reinterpret_cast<std::uint8_t const*>(second), std::strlen(second));
+    for (int i = 0; i < 100 && (!message_received || std::strlen(hm_message_buffer) < std::strlen(second)); i++) {
+      osDelay(1);
+    }
+    osDelay(20);
+    return hm10.linkStatistics().framesReceived - framesBefore;
+  };
+  check(deliverFragments("frag", "mented") == 2 && std::strcmp(hm_message_buffer, "mented") == 0,
+        "idle line framing splits the gap");
+  hm10.setFrameBoundary(HM10::FrameBoundary::Timeout, 10);
+  check(deliverFragments("frag", "mented") == 1 && std::strcmp(hm_message_buffer, "fragmented") == 0,
+        "timeout framing joins the fragments");
+  hm10.setFrameBoundary(HM10::FrameBoundary::Terminator, 50);
+  check(deliverFragments("+VERSION=", "MLT-BT05\r\n") == 1
+        && std::strcmp(hm_message_buffer, "+VERSION=MLT-BT05\r\n") == 0, "terminator framing");
+  check(deliverFragments("no ", "terminator") == 1 && std::strcmp(hm_message_buffer, "no terminator") == 0,
+        "terminator framing timeout");
+  hm10.setFrameBoundary(HM10::FrameBoundary::IdleLine);
+  ticking = false;
+  ticker.join();
+
+  // Deferred data callback runs in the timer service thread, after the interrupt, in order.
+  // Events over HM10_DEFERRED_EVENT_COUNT that arrive in one interrupt burst are dropped.
+  static std::string deferredData;
+  hm10.setDataCallback([](char* data, std::size_t length) {
+    deferredData.append(data, length);
+  }, HM10::CallbackDispatch::Deferred);
+  std::string expectedDeferredData;
+  std::size_t deferredBytesSent { 0 };
+  bool calledInInterrupt { false };
+  {
+    std::lock_guard<std::recursive_mutex> lock(HostUART::interruptLock());
+    for (int i = 0; i <= HM10_DEFERRED_EVENT_COUNT; i++) {
+      std::string const part = "d" + std::to_string(i);
+      HostUART::deliver(&huart1, reinterpret_cast<std::uint8_t const*>(part.data()), part.size());
+      deferredBytesSent += part.size();
+      if (i < HM10_DEFERRED_EVENT_COUNT) {
+        expectedDeferredData += part;
+      }
+    }
+    calledInInterrupt = !deferredData.empty();
+  }
+  for (int i = 0; i < 100 && deferredData.size() < expectedDeferredData.size(); i++) {
+    osDelay(1);
+  }
+  check(!calledInInterrupt && deferredData == expectedDeferredData && hm10.linkStatistics().droppedEvents == 1,
+        "deferred callbacks");
+  hm10.setDataCallback(dataCallback);
+
+  std::size_t const dataBytesSent = std::strlen("hello from master") + std::strlen("first") + std::strlen("second")
+                                    + tooLong.size() + std::strlen("after overrun") + std::strlen("fragmented") * 2
+                                    + std::strlen("+VERSION=MLT-BT05\r\n") + std::strlen("no terminator")
+                                    + deferredBytesSent;
+
+  // Housekeeping job submitted first still has to wait for the data, urgent goes before normal
+  HM10::TransferScheduler scheduler(hm10);
+  struct JobContext {
+    Host::HM10Emulator* emulator;
+    std::string dataBeforeJob;
+  } jobContext { &emulator, { } };
+  scheduler.submitJob([](HM10::HM10&, void* context) {
+    JobContext* const job = static_cast<JobContext*>(context);
+    job->dataBeforeJob = job->emulator->takeRemoteData();
+  }, &jobContext);
+  scheduler.submitData(reinterpret_cast<std::uint8_t const*>("normal;"), 7, HM10::TransferPriority::Normal);
+  scheduler.submitData(reinterpret_cast<std::uint8_t const*>("urgent;"), 7, HM10::TransferPriority::Urgent);
+  check(scheduler.dispatchAll() == 3 && jobContext.dataBeforeJob == "urgent;normal;", "scheduler priority order");
+
+  // Two producer tasks sharing the module through the service
+  HM10::HM10Service service(hm10);
+  check(service.start(), "service start");
+  auto const producer = [&service]() {
+    for (int i = 0; i < 10; i++) {
+      service.sendData(reinterpret_cast<std::uint8_t const*>("ab"), 2);
+    }
+  };
+  std::thread firstProducer(producer);
+  std::thread secondProducer(producer);
+  firstProducer.join();
+  secondProducer.join();
+  std::string expectedData { };
+  for (int i = 0; i < 20; i++) {
+    expectedData += "ab";
+  }
+  check(service.handledRequests() == 20 && emulator.takeRemoteData() == expectedData, "service with two producers");
+
+  emulator.disconnectRemote();
+  osDelay(50);
+  check(!hm10.isConnected(), "remote disconnected");
+  check(events.wait(HM10::EventBus::Disconnected, 100) == HM10::EventBus::Disconnected
+        && firstCounter.disconnected == 1 && secondCounter.disconnected == 1
+        && firstCounter.dataBytes == dataBytesSent
+        && secondCounter.dataBytes == firstCounter.dataBytes, "disconnected and data events");
+  hm10.setEventBus(nullptr);
+
+  // Central role: the peer drops the link, the supervisor reattaches with AT+CONNL, without a scan
+  emulator.addPeripheral({ "A1B2C3D4E5F6", "" });
+  emulator.setConnectTime(std::chrono::milliseconds(20));
+  check(hm10.setAutomaticMode(false) && hm10.setRole(HM10::Role::Central) && hm10.connect("A1B2C3D4E5F6", 1000),
+        "central connect");
+  HM10::LinkSupervisor supervisor(hm10, HM10::Role::Central);
+  check(supervisor.poll() && std::strcmp(supervisor.peer().address, "A1B2C3D4E5F6") == 0, "supervisor peer");
+  emulator.disconnectRemote();
+  for (int i = 0; i < 100 && hm10.isConnected(); i++) {
+    osDelay(1);
+  }
+  for (int i = 0; i < 200 && !supervisor.poll(); i++) {
+    osDelay(1);
+  }
+  HM10::SupervisorStatistics const supervision = supervisor.statistics();
+  check(hm10.isConnected() && supervision.linkLosses == 1 && supervision.fastReconnects == 1
+        && supervision.failedAttempts == 0, "supervisor reattach");
+  std::printf("Reconnect latency: %lu ms\n", static_cast<unsigned long>(supervision.lastReconnectLatency));
+
+  // Central poller: pollAll visits every target exactly once (the unreachable one too), the first round in the table
+  // order, then the backlog and the waiting time decide. The failed target keeps lastSeen at 0.
+  emulator.addPeripheral({ "0A0B0C0D0E0F", std::string(40, 'x') });
+  HM10::CentralPoller poller(hm10);
+  poller.setConnectTimeout(200);
+  poller.setDrainIdleTime(30);
+  check(poller.addTarget("A1B2C3D4E5F6") && poller.addTarget("0A0B0C0D0E0F") && poller.addTarget("111111111111")
+        && !poller.addTarget("A1B2C3D4E5F6") && !poller.addTarget("not a MAC"), "poller targets");
+  std::size_t const successfulVisits = poller.pollAll();
+  bool visitedOnce { true };
+  for (std::size_t i = 0; i < poller.targetCount(); i++) {
+    HM10::PeripheralStats const& stats = poller.target(i)->stats;
+    visitedOnce = visitedOnce && poller.target(i)->visited && stats.visits + stats.failedConnections == 1;
+  }
+  HM10::PeripheralTarget const& unreachable = *poller.target(2);
+  check(successfulVisits == 2 && visitedOnce && poller.target(1)->backlog == 40 && poller.stats().bytesReceived == 40
+        && unreachable.stats.failedConnections == 1 && unreachable.lastSeen == 0 && unreachable.lastAttempt != 0,
+        "poller visits every target once");
+  // Huge divisor - only the backlog counts: the peripheral that had data goes first in the next round,
+  // the others (equal scores) follow in the table order
+  poller.setAgingDivisor(100000);
+  std::size_t const secondRound = poller.pollAll();
+  bool const backlogFirst = poller.target(1)->lastSeen < poller.target(0)->lastSeen
+                            && poller.target(0)->lastAttempt < poller.target(2)->lastAttempt;
+  check(secondRound == 2 && backlogFirst && poller.target(0)->stats.visits == 2 && poller.target(1)->stats.visits == 2
+        && poller.target(2)->stats.failedConnections == 2 && poller.target(1)->stats.lastRevisitTime > 0,
+        "poller round starts with the biggest backlog");
+  // Divisor of 1 - the longest waiting target goes first
+  poller.setAgingDivisor(1);
+  check(poller.pollNext() && poller.target(1)->stats.visits == 3 && poller.target(0)->stats.visits == 2
+        && poller.stats().visits == 5 && !hm10.isConnected(), "poller picks the longest waiting target");
+
+  // iBeacon scan: the repeated sighting is merged, then the records older than the manually added one are erased
+  std::string const beaconUUID { "74278BDAB64445208F0C720EAF059935" };
+  emulator.addBeacon({ beaconUUID, 1, 2, -59, "B1B2B3B4B5B6", -60 });
+  emulator.addBeacon({ beaconUUID, 3, 4, -59, "C1C2C3C4C5C6", -70 });
+  emulator.addBeacon({ beaconUUID, 1, 2, -59, "B1B2B3B4B5B6", -80 });
+  static HM10::BeaconTable beacons { };
+  check(hm10.discoverBeacons(beacons, 1000) && beacons.size() == 2 && beacons.malformedLines() == 0,
+        "beacon scan");
+  HM10::BeaconRecord const* const repeated = beacons.find("B1B2B3B4B5B6");
+  check(repeated != nullptr && repeated->sightings == 2 && repeated->lastRSSI == -80 && repeated->averageRSSI() == -65
+        && repeated->major == 1 && repeated->minor == 2 && repeated->txPower == -59 && repeated->uuid[0] == 0x74
+        && repeated->uuid[15] == 0x35 && beacons.find("C1C2C3C4C5C6")->sightings == 1, "beacon dedup");
+  std::uint32_t const laterScan = platformTicks() + 1000;
+  std::string const line { "OK+DISC:4C000215:" + beaconUUID + ":00050006C5:D1D2D3D4D5D6:-050" };
+  beacons.beginScan();
+  beacons.ingest(line.data(), 30, laterScan);
+  beacons.ingest(line.data() + 30, line.size() - 30, laterScan);
+  std::string const malformed { "OK+DISC:4C000215:" + std::string(61, 'Z') };
+  beacons.ingest(malformed.data(), malformed.size(), laterScan);
+  check(beacons.size() == 3 && beacons.malformedLines() == 1 && beacons.find("D1D2D3D4D5D6") != nullptr,
+        "beacon line split between chunks");
+  check(beacons.removeOlderThan(laterScan) == 2 && beacons.size() == 1 && beacons.find("B1B2B3B4B5B6") == nullptr
+        && beacons.find("C1C2C3C4C5C6") == nullptr && beacons.find("D1D2D3D4D5D6")->minor == 6, "beacon erase");
+  check(hm10.setRole(HM10::Role::Peripheral) && hm10.setAutomaticMode(true), "back to peripheral");
+
+  // Configuration clone - snapshot, change two settings, restore only these two
+  std::uint8_t configuration[HM10::ConfigurationBlobSize] { };
+  HM10::DeviceName const originalName = hm10.name();
+  std::size_t const configurationLength = hm10.snapshot(configuration, sizeof(configuration));
+  check(configurationLength == HM10::ConfigurationBlobSize && hm10.setName("changed") && hm10.setServiceUUID(0x1234),
+        "configuration snapshot");
+  int const restored = hm10.restore(configuration, configurationLength, false);
+  check(restored == 2 && std::strcmp(hm10.name().name, originalName.name) == 0 && hm10.serviceUUID() == 0xDEAD,
+        "configuration restore");
+  configuration[20] ^= 0x01;
+  check(hm10.restore(configuration, configurationLength) == -1, "corrupted configuration rejected");
+
+  for (char const* command : { "NAME", "ROLE", "BAUD" }) {
+    HM10::CommandStatistics const stats = hm10.commandStatistics(command);
+    std::printf("AT+%-4s count: %2lu, timeouts: %lu, expected responses: %2lu, unexpected: %lu, max RTT: %lu ms\n",
+                command, static_cast<unsigned long>(stats.count), static_cast<unsigned long>(stats.timeouts),
+                static_cast<unsigned long>(stats.expectedResponses),
+                static_cast<unsigned long>(stats.unexpectedResponses),
+                static_cast<unsigned long>(stats.maxRoundTripTime));
+  }
+  HM10::LinkStatistics const link = hm10.linkStatistics();
+  std::printf("Link: %lu bytes in (%lu frames, %lu DMA wraps), %lu bytes out, %lu UART errors, %lu RX restarts\n",
+              static_cast<unsigned long>(link.bytesReceived), static_cast<unsigned long>(link.framesReceived),
+              static_cast<unsigned long>(link.dmaWraps), static_cast<unsigned long>(link.bytesTransmitted),
+              static_cast<unsigned long>(link.uartErrors), static_cast<unsigned long>(link.rxRestarts));
+
+#ifdef HM10_CAPTURE
+  // Session capture, replay it with Tools/hm10_replay (see `make replay`)
+  static std::uint8_t records[HM10_CAPTURE_BUFFER_SIZE] { };
+  std::uint8_t header[HM10::Capture::HeaderSize] { };
+  HM10::Capture::header(header);
+  std::size_t const recordsLength = capture.read(records, sizeof(records));
+  if (std::FILE* file = std::fopen("hm10_capture.bin", "wb")) {
+    std::fwrite(header, 1, sizeof(header), file);
+    std::fwrite(records, 1, recordsLength, file);
+    std::fclose(file);
+  }
+  std::printf("Capture: %zu bytes saved, %lu records dropped\n", recordsLength,
+              static_cast<unsigned long>(capture.droppedRecords()));
+#endif
+
+#ifdef HM10_TRACE_ENABLED
+  // Binary trace of debug logs, decode it with Tools/hm10_trace_decode (see `make trace`)
+  static std::uint8_t trace[HM10_TRACE_BUFFER_SIZE] { };
+  std::size_t const traceLength = HM10::Trace::read(trace, sizeof(trace));
+  if (std::FILE* file = std::fopen("hm10_trace.bin", "wb")) {
+    std::fwrite(trace, 1, traceLength, file);
+    std::fclose(file);
+  }
+  std::printf("Trace: %zu bytes saved, %lu records dropped\n", traceLength,
+              static_cast<unsigned long>(HM10::Trace::droppedRecords()));
+#endif
+
+#ifdef HM10_PROFILING
+  // On the host the "cycles" are nanoseconds
+  HM10::ProfilingStatistics const stats = hm10.stats();
+  char const* const siteNames[] = { "receiveCompleted", "transmitCompleted", "transmitAndReceive" };
+  for (std::size_t i = 0; i < sizeof(siteNames) / sizeof(siteNames[0]); i++) {
+    HM10::SiteStatistics const& site = stats.sites[i];
+    std::printf("%-20s calls: %6lu, min: %9lu ns, mean: %9lu ns, max: %9lu ns\n", siteNames[i],
+                static_cast<unsigned long>(site.calls), static_cast<unsigned long>(site.minCycles),
+                static_cast<unsigned long>(site.meanCycles()), static_cast<unsigned long>(site.maxCycles));
+  }
+#endif
+
+  std::printf("%s, %d failure(s)\n", (failures == 0 ? "All good" : "Something went wrong"), failures);
+  return failures == 0 ? 0 : 1;
+}
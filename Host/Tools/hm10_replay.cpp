@@ -0,0 +1,220 @@
+/*
+ * hm10_replay.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Replays the UART session captured with HM10_CAPTURE (see Drivers/HM-10/hm10_capture.hpp) against
+ * the current driver build. Every received message goes through the simulated UART and the idle line
+ * interrupt into `receiveCompleted()`, the responses are delivered while the driver is waiting for one
+ * (like in the original session), and the UART errors are raised again. Transmitted buffers are only counted.
+ *
+ * Usage: hm10_replay [--realtime] capture.bin
+ *   --realtime - keeps the original timing between the records, by default it runs as fast as possible.
+ *
+ * The outcome (callbacks, final state) is deterministic, so it can be compared between driver builds.
+ * The time spent in the interrupt path is printed separately.
+ */
+
+#include <hm10.hpp>
+#include "host_uart.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+USART_TypeDef usart1 { };
+DMA_Stream_TypeDef dmaRxStream { };
+DMA_HandleTypeDef hdmaRx { &dmaRxStream };
+UART_HandleTypeDef huart1 { &usart1, { 115200, 0, 0, 0, 0, 0, 0 }, nullptr, 0, nullptr, 0, nullptr, &hdmaRx,
+                            HAL_UART_STATE_READY, HAL_UART_STATE_READY, 0 };
+
+HM10::HM10 hm10(&huart1);
+
+extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+  if (huart == &huart1) {
+    hm10.transmitCompleted();
+  }
+}
+
+extern "C" void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+  if (huart == &huart1) {
+    hm10.errorOccurred();
+  }
+}
+
+namespace HM10 {
+
+struct HostAccess {
+  static void startReceiving(HM10& module) {
+    module.startReceivingToBuffer();
+  }
+
+  static void stopReceiving(HM10& module) {
+    module.abortReceiving();
+  }
+};
+
+}
+
+namespace {
+
+using HM10::HostAccess;
+
+constexpr std::size_t HeaderSize { 16 };
+constexpr std::size_t RecordHeaderSize { 7 };
+constexpr char Magic[8] { 'H', 'M', '1', '0', 'C', 'A', 'P', '\0' };
+
+enum RecordType : std::uint8_t {
+  Transmit = 0,
+  Receive = 1,
+  Response = 2,
+  UARTError = 3
+};
+
+struct Outcome {
+  std::size_t connected { 0 };
+  std::size_t disconnected { 0 };
+  std::size_t dataMessages { 0 };
+  std::size_t dataBytes { 0 };
+  // Simple checksum of all the data passed to the application, to compare the builds
+  std::uint32_t dataChecksum { 2166136261u };
+};
+
+Outcome outcome { };
+
+void dataCallback(char* data, std::size_t length) {
+  outcome.dataMessages++;
+  outcome.dataBytes += length;
+  for (std::size_t i = 0; i < length; i++) {
+    outcome.dataChecksum = (outcome.dataChecksum ^ static_cast<std::uint8_t>(data[i])) * 16777619u;
+  }
+}
+
+void connectedCallback(HM10::MACAddress const&) {
+  outcome.connected++;
+}
+
+void disconnectedCallback() {
+  outcome.disconnected++;
+}
+
+void idleLineHandler() {
+  if ((usart1.SR & USART_SR_IDLE) != 0) {
+    usart1.SR &= ~USART_SR_IDLE;
+    hm10.receiveCompleted();
+  }
+}
+
+std::uint32_t readU32(std::uint8_t const* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+}
+
+}
+
+int main(int argc, char** argv) {
+  bool realtime { false };
+  char const* path { nullptr };
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--realtime") == 0) {
+      realtime = true;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (path == nullptr) {
+    std::fprintf(stderr, "Usage: %s [--realtime] capture.bin\n", argv[0]);
+    return 1;
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<std::uint8_t> const capture((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (capture.size() < HeaderSize || std::memcmp(capture.data(), Magic, sizeof(Magic)) != 0) {
+    std::fprintf(stderr, "%s is not a HM-10 capture\n", path);
+    return 1;
+  }
+  std::uint32_t const frequency = readU32(&capture[12]);
+  if (capture[8] != 1 || frequency == 0) {
+    std::fprintf(stderr, "Unsupported capture version %u\n", static_cast<unsigned>(capture[8]));
+    return 1;
+  }
+
+  HostUART::setInterruptHandler(&huart1, idleLineHandler);
+  hm10.setDataCallback(dataCallback);
+  hm10.setDeviceConnectedCallback(connectedCallback);
+  hm10.setDeviceDisconnectedCallback(disconnectedCallback);
+  hm10.initialize();
+
+  using Clock = std::chrono::steady_clock;
+  Clock::duration interruptTime { };
+  Clock::duration maxInterruptTime { };
+  auto const replayStart = Clock::now();
+
+  std::size_t counts[4] { };
+  std::size_t frames { 0 };
+  std::uint64_t captureTime { 0 };
+  std::uint32_t previousTimestamp { 0 };
+
+  std::size_t position { HeaderSize };
+  while (position + RecordHeaderSize <= capture.size()) {
+    std::uint8_t const* const record = &capture[position];
+    std::size_t const length = record[5] | (record[6] << 8);
+    if (position + RecordHeaderSize + length > capture.size() || record[0] > UARTError) {
+      std::fprintf(stderr, "Corrupted record at offset %zu\n", position);
+      return 1;
+    }
+    std::uint8_t const* const data = record + RecordHeaderSize;
+    std::uint32_t const timestamp = readU32(&record[1]);
+    captureTime += (position == HeaderSize ? 0 : timestamp - previousTimestamp);
+    previousTimestamp = timestamp;
+    position += RecordHeaderSize + length;
+    counts[record[0]]++;
+
+    if (realtime) {
+      std::this_thread::sleep_until(replayStart + std::chrono::microseconds(captureTime * 1000000 / frequency));
+    }
+
+    if (record[0] == Transmit) {
+      continue;
+    }
+
+    auto const start = Clock::now();
+    if (record[0] == UARTError) {
+      HostUART::raiseError(&huart1, length >= 4 ? readU32(data) : 0, false);
+    } else {
+      if (record[0] == Response) {
+        HostAccess::startReceiving(hm10);
+      }
+      HostUART::deliver(&huart1, data, length);
+      if (record[0] == Response) {
+        HostAccess::stopReceiving(hm10);
+      }
+      frames++;
+    }
+    Clock::duration const elapsed = Clock::now() - start;
+    interruptTime += elapsed;
+    maxInterruptTime = std::max(maxInterruptTime, elapsed);
+  }
+
+  using Nanoseconds = std::chrono::duration<double, std::nano>;
+  HM10::LinkStatistics const link = hm10.linkStatistics();
+  std::printf("Capture: %zu TX, %zu RX, %zu responses, %zu UART errors, %.3f s\n", counts[Transmit],
+              counts[Receive], counts[Response], counts[UARTError], static_cast<double>(captureTime) / frequency);
+  std::printf("Outcome: %zu connected, %zu disconnected, %zu data messages (%zu bytes, checksum %08X), "
+              "%lu bytes received, final state: %s\n",
+              outcome.connected, outcome.disconnected, outcome.dataMessages, outcome.dataBytes,
+              outcome.dataChecksum, static_cast<unsigned long>(link.bytesReceived),
+              hm10.isConnected() ? "connected" : "disconnected");
+  std::printf("Interrupt path: %.1f ns/frame mean, %.1f ns max\n",
+              frames > 0 ? Nanoseconds(interruptTime).count() / frames : 0.0,
+              Nanoseconds(maxInterruptTime).count());
+  return 0;
+}
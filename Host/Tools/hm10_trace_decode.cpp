@@ -0,0 +1,212 @@
+/*
+ * hm10_trace_decode.cpp
+ *
+ *  Created on: 19 oct 2026
+ *      Author: SteelPh0enix
+ */
+
+/*
+ * Decoder of the HM-10 driver binary trace (see Drivers/HM-10/hm10_trace.hpp).
+ *
+ * Usage: hm10_trace_decode [-f frequency] strings.bin trace.bin
+ *   strings.bin - `hm10_trace` section dumped from the ELF file (objcopy --dump-section hm10_trace=strings.bin)
+ *   trace.bin   - records read from the trace ring buffer
+ *   frequency   - timestamp counter frequency in Hz, default is 96MHz (core clock of the example).
+ *                 Use 1000000000 for the traces from the host build.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t HeaderSize { 7 };
+
+enum ArgumentTag : std::uint8_t {
+  Word = 0,
+  DoubleWord = 1,
+  String = 2
+};
+
+struct Argument {
+  ArgumentTag tag;
+  std::uint64_t value;
+  std::string string;
+};
+
+bool readFile(char const* path, std::vector<std::uint8_t>& data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::fprintf(stderr, "Can't open %s\n", path);
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return true;
+}
+
+bool parseArguments(std::uint8_t const* data, std::size_t length, std::vector<Argument>& arguments) {
+  std::size_t position { 0 };
+  while (position < length) {
+    Argument argument { static_cast<ArgumentTag>(data[position++]), 0, { } };
+    switch (argument.tag) {
+    case Word:
+    case DoubleWord: {
+      std::size_t const size = (argument.tag == Word ? 4 : 8);
+      if (position + size > length) {
+        return false;
+      }
+      for (std::size_t i = 0; i < size; i++) {
+        argument.value |= static_cast<std::uint64_t>(data[position + i]) << (8 * i);
+      }
+      position += size;
+      break;
+    }
+    case String: {
+      if (position >= length || position + 1 + data[position] > length) {
+        return false;
+      }
+      std::size_t const size = data[position++];
+      argument.string.assign(reinterpret_cast<char const*>(&data[position]), size);
+      position += size;
+      break;
+    }
+    default:
+      return false;
+    }
+    arguments.push_back(argument);
+  }
+  return true;
+}
+
+std::string format(char const* pattern, std::vector<Argument> const& arguments) {
+  std::string output;
+  std::size_t next { 0 };
+  char buffer[256] { };
+
+  for (char const* c = pattern; *c != '\0'; c++) {
+    if (*c != '%') {
+      output += *c;
+      continue;
+    }
+    if (c[1] == '%') {
+      output += '%';
+      c++;
+      continue;
+    }
+
+    // Flags, width and precision are passed to snprintf as they are, length modifiers are replaced
+    std::string spec { "%" };
+    c++;
+    while (*c != '\0' && std::strchr("-+ #0123456789.", *c) != nullptr) {
+      spec += *c++;
+    }
+    while (*c != '\0' && std::strchr("hlzjtL", *c) != nullptr) {
+      c++;
+    }
+    if (*c == '\0') {
+      break;
+    }
+
+    if (next >= arguments.size()) {
+      output += "<missing>";
+      continue;
+    }
+    Argument const& argument = arguments[next++];
+    if ((argument.tag == String) != (*c == 's')) {
+      output += std::string("<bad %") + *c + ">";
+      continue;
+    }
+
+    switch (*c) {
+    case 'd':
+    case 'i': {
+      long long const value = (argument.tag == Word ? static_cast<std::int32_t>(argument.value)
+                                                    : static_cast<std::int64_t>(argument.value));
+      std::snprintf(buffer, sizeof(buffer), (spec + "lld").c_str(), value);
+      break;
+    }
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      std::snprintf(buffer, sizeof(buffer), (spec + "ll" + *c).c_str(), static_cast<unsigned long long>(argument.value));
+      break;
+    case 'c':
+      std::snprintf(buffer, sizeof(buffer), (spec + "c").c_str(), static_cast<int>(argument.value));
+      break;
+    case 'p':
+      std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(argument.value));
+      break;
+    case 's':
+      std::snprintf(buffer, sizeof(buffer), (spec + "s").c_str(), argument.string.c_str());
+      break;
+    default:
+      std::snprintf(buffer, sizeof(buffer), "<bad %%%c>", *c);
+      break;
+    }
+    output += buffer;
+  }
+
+  return output;
+}
+
+}
+
+int main(int argc, char** argv) {
+  double frequency { 96e6 };
+  int argument { 1 };
+  if (argc > 2 && std::strcmp(argv[1], "-f") == 0) {
+    frequency = std::strtod(argv[2], nullptr);
+    argument = 3;
+  }
+  if (argc - argument != 2 || frequency <= 0) {
+    std::fprintf(stderr, "Usage: %s [-f frequency] strings.bin trace.bin\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<std::uint8_t> strings;
+  std::vector<std::uint8_t> trace;
+  if (!readFile(argv[argument], strings) || !readFile(argv[argument + 1], trace)) {
+    return 1;
+  }
+  strings.push_back('\0');
+
+  // Timestamps are relative to the first record, deltas are computed modulo 2^32 so counter wrap is handled
+  std::uint64_t time { 0 };
+  std::uint32_t previousTimestamp { 0 };
+  bool first { true };
+
+  std::size_t position { 0 };
+  while (position < trace.size()) {
+    std::size_t const length = trace[position];
+    if (length < HeaderSize || position + length > trace.size()) {
+      std::fprintf(stderr, "Corrupted record at offset %zu\n", position);
+      return 1;
+    }
+
+    std::uint8_t const* const record = &trace[position];
+    std::size_t const id = record[1] | (record[2] << 8);
+    std::uint32_t const timestamp = record[3] | (record[4] << 8) | (record[5] << 16)
+                                    | (static_cast<std::uint32_t>(record[6]) << 24);
+    time += (first ? 0 : static_cast<std::uint32_t>(timestamp - previousTimestamp));
+    previousTimestamp = timestamp;
+    first = false;
+
+    std::vector<Argument> arguments;
+    if (id >= strings.size() || !parseArguments(record + HeaderSize, length - HeaderSize, arguments)) {
+      std::printf("%14.3f us  <invalid record, ID %zu>\n", time * 1e6 / frequency, id);
+    } else {
+      char const* const pattern = reinterpret_cast<char const*>(&strings[id]);
+      std::printf("%14.3f us  %s\n", time * 1e6 / frequency, format(pattern, arguments).c_str());
+    }
+    position += length;
+  }
+
+  return 0;
+}
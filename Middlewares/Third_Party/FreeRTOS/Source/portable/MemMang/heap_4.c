@@ -45,9 +45,12 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
-#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
-	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
-#endif
+/* HM10 example: the heap-free build (HM10_STATIC_ALLOCATION) turns off
+configSUPPORT_DYNAMIC_ALLOCATION in FreeRTOSConfig.h.  The file compiles to
+nothing then, instead of failing the build, so it doesn't have to be excluded
+from the project by hand.  Anything that still calls pvPortMalloc() fails to
+link. */
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 0 )
 
 /* Block sizes must not get too small. */
 #define heapMINIMUM_BLOCK_SIZE	( ( size_t ) ( xHeapStructSize << 1 ) )
@@ -490,3 +493,5 @@ size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY use
 	taskEXIT_CRITICAL();
 }
 
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION != 0 */